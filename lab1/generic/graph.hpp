@@ -3,6 +3,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <numeric>
 #include <deque>
 #include <queue>
 #include <stack>
@@ -10,6 +11,8 @@
 #include <cmath>
 #include <functional>
 #include <stdexcept>
+#include <unordered_map>
+#include <span>
 
 
 
@@ -17,43 +20,98 @@
 
 // Declarations 
 namespace graph {
+    template <bool Directed, bool InEdges = Directed>
+    struct graph_traits {
+        // compile-time storage policy of a graph
+        // an undirected graph keeps a single adjacency list per vertex - its in-edges are its out-edges
+        static constexpr bool directed = Directed;
+        static constexpr bool stores_in_edges = Directed && InEdges;
+        static constexpr bool has_in_edges = !Directed || InEdges;
+    };
+
+    typedef graph_traits<true> directed_t; // out and in adjacency lists
+    typedef graph_traits<true, false> out_directed_t; // out adjacency lists only
+    typedef graph_traits<false> undirected_t;
+
+    template <bool InEdges>
+    struct _vertex_descriptor {
+        std::vector <int> adjacent_in;
+        std::vector <int> adjacent_out;
+    };
+
+    template <>
+    struct _vertex_descriptor <false> {
+        std::vector <int> adjacent_out;
+    };
+
     template <typename T>
     struct graph_t {
         typedef std::pair <T, T> edge;
-        struct vertex_descriptor {
-            std::vector <T> adjacent_in;
-            std::vector <T> adjacent_out;
-            // TODO: vector<T> -> vector<edge_descriptor<T>>
-        };
+        template <typename Traits>
+        using vertex_descriptor = _vertex_descriptor <Traits::stores_in_edges>;
+        // TODO: vector<T> -> vector<edge_descriptor<T>>
         typedef std::vector <std::vector <T>> partition;
     };
 
 
 
-    template <typename T>
+    template <typename T, typename Traits = directed_t>
+    class Graph;
+
+    template <typename T, typename Traits = directed_t>
+    class GraphView {
+        // Non-owning, read-only view of a Graph's vertices and adjacency lists
+        // Cheap to copy - the algorithms take it by value
+        private:
+            const std::vector <T> *vertices = nullptr;
+            const std::vector <typename graph_t<T>::template vertex_descriptor<Traits>> *adjacency_list = nullptr;
+
+        public:
+            GraphView() = default;
+            GraphView (const Graph <T, Traits> &graph);
+            ~GraphView() = default;
+
+            static constexpr bool is_directed();
+            bool is_empty() const;
+            int num_vertices() const;
+            const T& operator [] (int index) const; // returns vertex 'name'
+            std::span <const int> adjacent_in (int index) const; // returns span of indices - requires Traits::has_in_edges
+            std::span <const int> adjacent_out (int index) const; // returns span of indices
+            int in_deg (int index) const; // requires Traits::has_in_edges
+            int out_deg (int index) const;
+    };
+
+
+
+    template <typename T, typename Traits>
     class Graph {
+        // Traits: directedness and the in-edge storage (graph_traits) - the adjacency lists
+        // which are not needed are not allocated and add_edge does not branch at runtime
         private:
-            bool directed;
-            std::vector <T> vertices;
-            std::vector <typename graph_t<int>::vertex_descriptor> adjacency_list;
+            std::vector <T> vertices; // index -> vertex 'name'
+            std::unordered_map <T, int> indices; // vertex 'name' -> index
+            std::vector <typename graph_t<T>::template vertex_descriptor<Traits>> adjacency_list;
+
+            friend class GraphView<T, Traits>;
 
         public:
             Graph() = default;
-            Graph (bool directed);
             ~Graph() = default;
 
-            void show();
-            bool is_directed();
-            bool is_empty();
-            int num_vertices();
-            std::vector <T> get_vertices();
-            int index_of (T vertex);
+            void show() const;
+            static constexpr bool is_directed();
+            bool is_empty() const;
+            int num_vertices() const;
+            std::vector <T> get_vertices() const;
+            int index_of (T vertex) const; // returns num_vertices() for unknown vertices
             T& operator [] (int index); // returns vertex 'name'
-            std::vector <int> adjacent_in (int index); // returns vector of indices
-            std::vector <int> adjacent_out (int index); // returns vector of indices
-            int in_deg (int index);
-            int out_deg (int index);
+            const T& operator [] (int index) const;
+            std::span <const int> adjacent_in (int index) const; // returns span of indices - requires Traits::has_in_edges
+            std::span <const int> adjacent_out (int index) const; // returns span of indices
+            int in_deg (int index) const; // requires Traits::has_in_edges
+            int out_deg (int index) const;
             void add_vertex (T vertex);
+            void add_vertices (const std::vector <T> &vertices);
             void add_edge (typename graph_t<T>::edge edge);
     };
 
@@ -71,37 +129,56 @@ namespace graph {
             std::function <void(std::deque<T>&)> pop_first;
         };
 
-        template <typename T>
-        Graph <T> search (Graph <T> graph, bool depth_first);
+        // every algorithm takes a GraphView - the Graph overloads only wrap the graph in a view
+        // the search tree keeps the out-edges only
+        template <typename T, typename Traits>
+        Graph <T, out_directed_t> search (GraphView <T, Traits> graph, bool depth_first);
+
+        template <typename T, typename Traits>
+        Graph <T, out_directed_t> search (const Graph <T, Traits> &graph, bool depth_first);
 
 
         // finding graph's topological order or acyclicity
-        template <typename T>
-        std::vector <T> topological_sort (Graph <T> graph);
+        // requires a directed graph with in-edges (directed_t)
+        template <typename T, typename Traits>
+        std::vector <T> topological_sort (GraphView <T, Traits> graph);
+
+        template <typename T, typename Traits>
+        std::vector <T> topological_sort (const Graph <T, Traits> &graph);
 
 
         // finding graph's strongly connected componnents
+        // Pearce's space-efficient variant of Tarjan's algorithm (iterative) - O(|V| + |E|)
         template <typename T>
         struct _scc_s {
             // structures required for the strong connecting algorithm
-            std::vector <int> componnent_index;
-            std::vector <int> low_link;
-            std::vector <bool> on_stack;
-            std::stack <int> stack;
+            std::vector <int> rindex; // 0: not visited, becomes num_vertices - componnent index
+            std::vector <bool> root;
+            std::vector <int> stack; // visited vertices not assigned to a componnent yet
+            std::vector <std::pair <int, std::size_t>> dfs_stack; // (vertex index, edge cursor)
+            int index;
             int componnent;
-            graph_t<T>::partition scc;
         };
 
         template <typename T>
-        void _scc_unit (Graph <T> graph, _scc_s <T> &cs, std::stack <int> &dfs_stack);
+        void _scc_visit (_scc_s <T> &cs, int v_idx);
 
-        template <typename T>
-        graph_t<T>::partition scc (Graph <T> graph);
+        template <typename T, typename Traits>
+        void _scc_unit (GraphView <T, Traits> graph, _scc_s <T> &cs, int vertex_idx);
+
+        template <typename T, typename Traits>
+        graph_t<T>::partition scc (GraphView <T, Traits> graph);
+
+        template <typename T, typename Traits>
+        graph_t<T>::partition scc (const Graph <T, Traits> &graph);
 
 
         // checking if a graph is bipartite
-        template <typename T>
-        graph_t<T>::partition bipartite_partition (Graph <T> graph);
+        template <typename T, typename Traits>
+        graph_t<T>::partition bipartite_partition (GraphView <T, Traits> graph);
+
+        template <typename T, typename Traits>
+        graph_t<T>::partition bipartite_partition (const Graph <T, Traits> &graph);
     };
 
 
@@ -115,35 +192,39 @@ namespace graph {
     m - number of edges
     list of m edges in a "u v" format
     */
-    Graph <int> int_graph_from_file (std::string file_name) {
+    bool is_directed_file (std::string file_name) {
+        // the graph type decides the Traits of the graph to read
+        std::ifstream infile(file_name);
+        char g_type = 0;
+        infile >> g_type;
+        return g_type == 'D';
+    }
+
+    template <typename Traits>
+    Graph <int, Traits> int_graph_from_file (std::string file_name) {
         try {
             std::cout << "Reading data...\n";
             std::ifstream infile;
             infile.open(file_name);
 
-            Graph <int> graph;
+            Graph <int, Traits> graph;
             char g_type;
 
             infile >> g_type;
-            switch (g_type) {
-                case 'D': {
-                    graph = Graph<int>(true);
-                    break;
-                }
-                case 'U': {
-                    graph = Graph<int>(false);
-                    break;
-                }
-                default: {
-                    std::string message = "Invalid graph type (" + std::to_string(g_type) + ") - must be 'U' or 'D'";
-                    throw std::invalid_argument(message);
-                }
+            if (g_type != 'D' && g_type != 'U') {
+                std::string message = "Invalid graph type (" + std::to_string(g_type) + ") - must be 'U' or 'D'";
+                throw std::invalid_argument(message);
+            }
+            if ((g_type == 'D') != Traits::directed) {
+                std::string message = "Graph type (" + std::string(1, g_type) + ") does not match the graph traits";
+                throw std::invalid_argument(message);
             }
             
             int n_vertices, n_edges;
             infile >> n_vertices >> n_edges;
-            for (int i = 0; i < n_vertices; i++) 
-                graph.add_vertex(i + 1);
+            std::vector <int> vertices(n_vertices);
+            std::iota(vertices.begin(), vertices.end(), 1);
+            graph.add_vertices(vertices);
 
             int v, u;
             for (int i = 0; i < n_edges; i++) {
@@ -170,14 +251,61 @@ namespace graph {
 // Definitions
 using namespace graph;
 
-// Graph container
-template <typename T>
-Graph<T>::Graph (bool directed) {
-    this->directed = directed;
+// Graph view
+template <typename T, typename Traits>
+GraphView<T, Traits>::GraphView (const Graph <T, Traits> &graph) {
+    this->vertices = &graph.vertices;
+    this->adjacency_list = &graph.adjacency_list;
 }
 
-template <typename T>
-void Graph<T>::show() {
+template <typename T, typename Traits>
+constexpr bool GraphView<T, Traits>::is_directed () {
+    return Traits::directed;
+}
+
+template <typename T, typename Traits>
+bool GraphView<T, Traits>::is_empty () const {
+    return this->vertices->empty();
+}
+
+template <typename T, typename Traits>
+int GraphView<T, Traits>::num_vertices () const {
+    return this->vertices->size();
+}
+
+template <typename T, typename Traits>
+const T& GraphView<T, Traits>::operator[] (int index) const {
+    return (*this->vertices)[index];
+}
+
+template <typename T, typename Traits>
+std::span <const int> GraphView<T, Traits>::adjacent_in (int index) const {
+    static_assert(Traits::has_in_edges, "The graph does not store in-edges");
+    if constexpr (Traits::directed)
+        return (*this->adjacency_list)[index].adjacent_in;
+    else
+        return (*this->adjacency_list)[index].adjacent_out;
+}
+
+template <typename T, typename Traits>
+std::span <const int> GraphView<T, Traits>::adjacent_out (int index) const {
+    return (*this->adjacency_list)[index].adjacent_out;
+}
+
+template <typename T, typename Traits>
+int GraphView<T, Traits>::in_deg (int index) const {
+    return this->adjacent_in(index).size();
+}
+
+template <typename T, typename Traits>
+int GraphView<T, Traits>::out_deg (int index) const {
+    return (*this->adjacency_list)[index].adjacent_out.size();
+}
+
+
+// Graph container
+template <typename T, typename Traits>
+void Graph<T, Traits>::show() const {
     int num_vertices = this->vertices.size();
     for (int v_idx = 0; v_idx < num_vertices; v_idx++) {
         std::cout << this->vertices[v_idx] << ": ";
@@ -187,77 +315,99 @@ void Graph<T>::show() {
     }
 }
 
-template <typename T>
-bool Graph<T>::is_directed () {
-    return this->directed;
+template <typename T, typename Traits>
+constexpr bool Graph<T, Traits>::is_directed () {
+    return Traits::directed;
 }
 
-template <typename T>
-bool Graph<T>::is_empty () {
+template <typename T, typename Traits>
+bool Graph<T, Traits>::is_empty () const {
     return this->vertices.empty();
 }
 
-template <typename T>
-int Graph<T>::num_vertices () {
+template <typename T, typename Traits>
+int Graph<T, Traits>::num_vertices () const {
     return this->vertices.size();
 }
 
-template <typename T>
-std::vector <T> Graph<T>::get_vertices () {
+template <typename T, typename Traits>
+std::vector <T> Graph<T, Traits>::get_vertices () const {
     return this->vertices;
 }
 
-template <typename T>
-int Graph<T>::index_of (T vertex) {
-    std::vector<int>::iterator it = std::find(this->vertices.begin(), this->vertices.end(), vertex);
-    return (it - this->vertices.begin());
+template <typename T, typename Traits>
+int Graph<T, Traits>::index_of (T vertex) const {
+    auto it = this->indices.find(vertex);
+    if (it == this->indices.end())
+        return this->vertices.size();
+    return it->second;
 }
 
-template <typename T>
-T& Graph<T>::operator[] (int index) {
+template <typename T, typename Traits>
+T& Graph<T, Traits>::operator[] (int index) {
     return this->vertices[index];
 }
 
-template <typename T>
-std::vector <int> Graph<T>::adjacent_in (int index) {
-    return this->adjacency_list[index].adjacent_in;
+template <typename T, typename Traits>
+const T& Graph<T, Traits>::operator[] (int index) const {
+    return this->vertices[index];
 }
 
-template <typename T>
-std::vector <int> Graph<T>::adjacent_out (int index) {
+template <typename T, typename Traits>
+std::span <const int> Graph<T, Traits>::adjacent_in (int index) const {
+    static_assert(Traits::has_in_edges, "The graph does not store in-edges");
+    if constexpr (Traits::directed)
+        return this->adjacency_list[index].adjacent_in;
+    else
+        return this->adjacency_list[index].adjacent_out;
+}
+
+template <typename T, typename Traits>
+std::span <const int> Graph<T, Traits>::adjacent_out (int index) const {
     return this->adjacency_list[index].adjacent_out;
 }
 
-template <typename T>
-int Graph<T>::in_deg (int index) {
-    return this->adjacency_list[index].adjacent_in.size();
+template <typename T, typename Traits>
+int Graph<T, Traits>::in_deg (int index) const {
+    return this->adjacent_in(index).size();
 }
 
-template <typename T>
-int Graph<T>::out_deg (int index) {
+template <typename T, typename Traits>
+int Graph<T, Traits>::out_deg (int index) const {
     return this->adjacency_list[index].adjacent_out.size();
 }
 
-template <typename T>
-void Graph<T>::add_vertex (T vertex) {
-    if (this->index_of(vertex) == this->vertices.size()) {
+template <typename T, typename Traits>
+void Graph<T, Traits>::add_vertex (T vertex) {
+    if (this->indices.try_emplace(vertex, this->vertices.size()).second) {
         this->vertices.push_back(vertex);
-        this->adjacency_list.push_back(typename graph_t<T>::vertex_descriptor{});
+        this->adjacency_list.push_back(typename graph_t<T>::template vertex_descriptor<Traits>{});
     }
 }
 
-template <typename T>
-void Graph<T>::add_edge (typename graph_t<T>::edge edge) {
+template <typename T, typename Traits>
+void Graph<T, Traits>::add_vertices (const std::vector <T> &vertices) {
+    // bulk insertion - reserves the storage once for all the new vertices
+    std::size_t capacity = this->vertices.size() + vertices.size();
+    this->vertices.reserve(capacity);
+    this->indices.reserve(capacity);
+    this->adjacency_list.reserve(capacity);
+
+    for (const T &vertex : vertices)
+        this->add_vertex(vertex);
+}
+
+template <typename T, typename Traits>
+void Graph<T, Traits>::add_edge (typename graph_t<T>::edge edge) {
     try {
         int first_idx = this->index_of(edge.first);
         int second_idx = this->index_of(edge.second);
 
         this->adjacency_list[first_idx].adjacent_out.push_back(second_idx);
-        this->adjacency_list[second_idx].adjacent_in.push_back(first_idx);
-        if (!this->directed) {
+        if constexpr (Traits::stores_in_edges)
+            this->adjacency_list[second_idx].adjacent_in.push_back(first_idx);
+        if constexpr (!Traits::directed)
             this->adjacency_list[second_idx].adjacent_out.push_back(first_idx);
-            this->adjacency_list[first_idx].adjacent_in.push_back(second_idx);
-        }
     }
     catch (std::exception &e) {
         std::cout << "Error: Cannot add edge!\n" << e.what();
@@ -269,13 +419,13 @@ void Graph<T>::add_edge (typename graph_t<T>::edge edge) {
 
 // Graph algorithms
 // dfs, bfs
-template <typename T>
-Graph <T> algorithm::search (Graph <T> graph, bool depth_first) {
+template <typename T, typename Traits>
+Graph <T, out_directed_t> algorithm::search (GraphView <T, Traits> graph, bool depth_first) {
     // TODO: vertices stack -> vertex indices stack
     int num_vertices = graph.num_vertices();
     std::vector <bool> visited = std::vector<bool>(num_vertices, false);
     std::vector <int> parent_idx = std::vector<int>(num_vertices, -1);
-    Graph <T> search_tree(true);
+    Graph <T, out_directed_t> search_tree;
 
     std::deque <int> container; // dfs: stack, bfs: queue - index container
     algorithm::_container_f <int> cf;
@@ -321,12 +471,17 @@ Graph <T> algorithm::search (Graph <T> graph, bool depth_first) {
     return search_tree;
 }
 
+template <typename T, typename Traits>
+Graph <T, out_directed_t> algorithm::search (const Graph <T, Traits> &graph, bool depth_first) {
+    return algorithm::search(GraphView<T, Traits>(graph), depth_first);
+}
+
 
 // finding graph's topological order or acyclicity
-template <typename T>
-std::vector <T> algorithm::topological_sort (Graph <T> graph) {
-    if (!graph.is_directed()) 
-        throw std::invalid_argument("Graph is NOT directed!");
+template <typename T, typename Traits>
+std::vector <T> algorithm::topological_sort (GraphView <T, Traits> graph) {
+    static_assert(Traits::directed, "Graph is NOT directed!");
+    static_assert(Traits::has_in_edges, "The topological sort requires the in-edges");
 
     int num_vertices = graph.num_vertices();
 
@@ -357,79 +512,97 @@ std::vector <T> algorithm::topological_sort (Graph <T> graph) {
     return topological_order;
 }
 
+template <typename T, typename Traits>
+std::vector <T> algorithm::topological_sort (const Graph <T, Traits> &graph) {
+    return algorithm::topological_sort(GraphView<T, Traits>(graph));
+}
+
 
 // finding graph's strongly connected componnents
 template <typename T>
-void algorithm::_scc_unit (Graph <T> graph, algorithm::_scc_s <T> &cs, std::stack <int> &dfs_stack) {
-    // Tarjan's strongly connected components algorithm (iterative)
-    while (!dfs_stack.empty()) {
-        int v_idx = dfs_stack.top();
-
-        if (!cs.on_stack[v_idx]) {
-            cs.stack.push(v_idx);
-            cs.on_stack[v_idx] = true;
-        }
-
-        if (cs.componnent_index[v_idx] == -1) 
-            cs.componnent_index[v_idx] = cs.low_link[v_idx] = cs.componnent++;
+void algorithm::_scc_visit (algorithm::_scc_s <T> &cs, int v_idx) {
+    cs.rindex[v_idx] = cs.index++;
+    cs.root[v_idx] = true;
+    cs.dfs_stack.push_back(std::make_pair(v_idx, 0));
+}
 
-        for (int adj_idx : graph.adjacent_out(v_idx)) {
-            if (cs.componnent_index[adj_idx] == -1) {
-                dfs_stack.push(adj_idx);
+template <typename T, typename Traits>
+void algorithm::_scc_unit (GraphView <T, Traits> graph, algorithm::_scc_s <T> &cs, int vertex_idx) {
+    // every edge is examined once, or twice if it leads to a new vertex:
+    // the cursor stays on the edge so that it is finished when the search returns from it
+    algorithm::_scc_visit(cs, vertex_idx);
+    while (!cs.dfs_stack.empty()) {
+        auto [v_idx, cursor] = cs.dfs_stack.back();
+        std::span <const int> adjacent = graph.adjacent_out(v_idx);
+
+        for (; cursor < adjacent.size(); cursor++) {
+            int adj_idx = adjacent[cursor];
+            if (cs.rindex[adj_idx] == 0)
                 break;
+
+            if (cs.rindex[adj_idx] < cs.rindex[v_idx]) {
+                cs.rindex[v_idx] = cs.rindex[adj_idx];
+                cs.root[v_idx] = false;
             }
-            else if (cs.on_stack[adj_idx])
-                cs.low_link[v_idx] = std::min(cs.low_link[v_idx], cs.low_link[adj_idx]);
         }
 
-        // If there are still vertices adjacent to v on the (dfs)stack 
-        if (dfs_stack.top()!= v_idx) 
+        if (cursor < adjacent.size()) {
+            cs.dfs_stack.back().second = cursor;
+            algorithm::_scc_visit(cs, adjacent[cursor]);
             continue;
+        }
 
-        // if vertex is the root of a strongly connected componnent 
-        // push stacked vertices to the new_componnent (until vertex is found)
-        if (cs.low_link[v_idx] == cs.componnent_index[v_idx]) {
-            std::vector <T> new_componnent;
-            while (cs.on_stack[v_idx]) {
-                int w_idx = cs.stack.top();
-                cs.stack.pop();
-                cs.on_stack[w_idx] = false;
-                new_componnent.push_back(graph[w_idx]);
-            }
-            cs.scc.push_back(new_componnent);
+        cs.dfs_stack.pop_back();
+        if (!cs.root[v_idx]) {
+            cs.stack.push_back(v_idx);
+            continue;
         }
 
-        dfs_stack.pop();
+        // v is the root of a strongly connected componnent - 
+        // assign it and the stacked vertices visited after it
+        cs.index--;
+        while (!cs.stack.empty() && cs.rindex[v_idx] <= cs.rindex[cs.stack.back()]) {
+            cs.rindex[cs.stack.back()] = cs.componnent;
+            cs.stack.pop_back();
+            cs.index--;
+        }
+        cs.rindex[v_idx] = cs.componnent--;
     }
 }
 
-template <typename T>
-graph_t<T>::partition algorithm::scc (Graph <T> graph) {
+template <typename T, typename Traits>
+graph_t<T>::partition algorithm::scc (GraphView <T, Traits> graph) {
     int num_vertices = graph.num_vertices();
     algorithm::_scc_s <T> cs = {
-        .componnent_index = std::vector<int>(num_vertices, -1),
-        .low_link = std::vector<int>(num_vertices, -1),
-        .on_stack = std::vector<bool>(num_vertices, false),
-        .stack = std::stack<int>(), 
-        .componnent = 0,
-        .scc = typename graph_t<T>::partition()
+        .rindex = std::vector<int>(num_vertices, 0),
+        .root = std::vector<bool>(num_vertices, false),
+        .stack = std::vector<int>(),
+        .dfs_stack = std::vector<std::pair<int, std::size_t>>(),
+        .index = 1,
+        .componnent = num_vertices
     };
 
-    std::stack <int> dfs_stack; 
-
     for (int v_idx = 0; v_idx < num_vertices; v_idx++) 
-        if (cs.componnent_index[v_idx] == -1) {
-            dfs_stack.push(graph[v_idx]);
-            algorithm::_scc_unit(graph, cs, dfs_stack);
-        }
+        if (cs.rindex[v_idx] == 0)
+            algorithm::_scc_unit(graph, cs, v_idx);
+
+    // componnents in the order of completion
+    typename graph_t<T>::partition scc(num_vertices - cs.componnent);
+    for (int v_idx = 0; v_idx < num_vertices; v_idx++)
+        scc[num_vertices - cs.rindex[v_idx]].push_back(graph[v_idx]);
+
+    return scc;
+}
 
-    return cs.scc;
+template <typename T, typename Traits>
+graph_t<T>::partition algorithm::scc (const Graph <T, Traits> &graph) {
+    return algorithm::scc(GraphView<T, Traits>(graph));
 }
 
 
 // checking if a graph is bipartite
-template <typename T>
-graph_t<T>::partition algorithm::bipartite_partition (Graph <T> graph) {
+template <typename T, typename Traits>
+graph_t<T>::partition algorithm::bipartite_partition (GraphView <T, Traits> graph) {
     // O(|V| + |E|) time complexity
     const int gray = 0; // not yet visited
     const int red = 1;
@@ -472,4 +645,9 @@ graph_t<T>::partition algorithm::bipartite_partition (Graph <T> graph) {
     bp.push_back(red_vertices);
     bp.push_back(blue_vertices);
     return bp;
+}
+
+template <typename T, typename Traits>
+graph_t<T>::partition algorithm::bipartite_partition (const Graph <T, Traits> &graph) {
+    return algorithm::bipartite_partition(GraphView<T, Traits>(graph));
 }
\ No newline at end of file
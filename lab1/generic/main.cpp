@@ -6,49 +6,43 @@
 
 
 
-int main(int argc, char* argv[]) {
-    // std::ios_base::sync_with_stdio(0);
-    // std::cin.tie(NULL);
-
-    if (argc < 3) {
-        printf("Error: Invalid arguments\n");
-        return 1;
-    }
-
-    std::string algorithm = argv[1];
-    std::string file_name = argv[2];
-
-    graph::Graph <int> graph = graph::int_graph_from_file(file_name);
+template <typename Traits>
+int run (std::string algorithm, std::string file_name) {
+    graph::Graph <int, Traits> graph = graph::int_graph_from_file<Traits>(file_name);
     // graph.show();
 
     // exercise 1
     if (algorithm == "dfs") {
         std::cout << "\nDFS search tree:\n";
-        graph::Graph <int> dfs_tree = graph::algorithm::search(graph, true);
+        graph::Graph <int, graph::out_directed_t> dfs_tree = graph::algorithm::search(graph, true);
         dfs_tree.show();
     }
     else if (algorithm == "bfs") {
         std::cout << "\n\nBFS search tree:\n";
-        graph::Graph <int> dfs_tree = graph::algorithm::search(graph, false);
+        graph::Graph <int, graph::out_directed_t> dfs_tree = graph::algorithm::search(graph, false);
         dfs_tree.show();
     }
 
     // exercise 2
     else if (algorithm == "ts") {
         std::cout << "\nTopological order:\n";
-        try {
-            std::vector <int> topological_order = graph::algorithm::topological_sort(graph);
-            if (graph.num_vertices() <= 200) {
-                for (int v : topological_order)
-                    std::cout << v << " ";
-                std::cout << "\n";
+        if constexpr (Traits::stores_in_edges) { // directed graphs are read with their in-edges for ts
+            try {
+                std::vector <int> topological_order = graph::algorithm::topological_sort(graph);
+                if (graph.num_vertices() <= 200) {
+                    for (int v : topological_order)
+                        std::cout << v << " ";
+                    std::cout << "\n";
+                }
+                else 
+                    std::cout << "Graph is sortable topologically!\n";
+            }
+            catch (std::invalid_argument &e) {
+                std::cout << e.what() << "\n";
             }
-            else 
-                std::cout << "Graph is sortable topologically!\n";
-        }
-        catch (std::invalid_argument &e) {
-            std::cout << e.what() << "\n";
         }
+        else
+            std::cout << "Graph is NOT directed!\n";
 
     }
 
@@ -93,4 +87,26 @@ int main(int argc, char* argv[]) {
     }
     
     return 0;
+}
+
+
+
+int main(int argc, char* argv[]) {
+    // std::ios_base::sync_with_stdio(0);
+    // std::cin.tie(NULL);
+
+    if (argc < 3) {
+        printf("Error: Invalid arguments\n");
+        return 1;
+    }
+
+    std::string algorithm = argv[1];
+    std::string file_name = argv[2];
+
+    // only the topological sort needs the in-edges of a directed graph
+    if (!graph::is_directed_file(file_name))
+        return run<graph::undirected_t>(algorithm, file_name);
+    if (algorithm == "ts")
+        return run<graph::directed_t>(algorithm, file_name);
+    return run<graph::out_directed_t>(algorithm, file_name);
 }
\ No newline at end of file
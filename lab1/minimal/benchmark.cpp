@@ -0,0 +1,822 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <regex>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <sys/resource.h>
+#include "graph.hpp"
+#include "reorder.hpp"
+#include "msbfs.hpp"
+#include "reachability.hpp"
+#include "compressed.hpp"
+#include "generators.hpp"
+#include "dynamic_order.hpp"
+#include "union_find.hpp"
+#include "parallel.hpp"
+
+
+
+
+
+// usage: ./benchmark <reorder|msbfs|reach|compress|build|dynamic|unite> <graph file | generator> [repeats]
+// generator: "model:scale[:edge factor[:D|U[:seed]]]" - a seeded synthetic graph (see generators.hpp)
+// reorder: locality benchmark of the vertex orderings - every algorithm runs on the graph
+//          relabeled by each ordering and the results are mapped back to the original ids
+// msbfs: throughput of the multi-source bfs against one search per source
+// reach: random u -> v queries answered by the reachability index against one bfs per query
+// compress: size and traversal speed of the compressed adjacency against the CSR, for several orderings
+// build: construction of the CSR from the edge array - add_edge + freeze against the radix sorted bulk builder
+// dynamic: the edges streamed into the dynamic topological order against a topological_sort per insert -
+//          the order is checked after the inserts and every rejected edge must close a cycle
+// unite: the edges united concurrently in the parity union-find by 1 to 8 threads - every run is checked against
+//        the single-threaded components and bipartiteness, and on the bipartite double cover of the graph
+//
+// usage: ./benchmark suite <results file (.json|.csv)> [--repeats=N] [--warmups=N] [--scales=s1,s2,..] [--edge-factors=f1,f2,..]
+//                          [--graphs=spec1,spec2,..] [--baseline=<results file>] [--threshold=fraction] [--min-sample=seconds]
+//                          [--min-repeats=N] [--min-time=seconds]
+// suite: dfs, bfs, scc, ts and bi over a matrix of generated graphs - the median and the percentiles
+//        of the times, edges / s and the peak RSS of every case, compared against a baseline run
+//        regressions are flagged only with at least `min-repeats` repeats and a baseline median of `min-time`
+
+struct Timing {
+    std::vector <double> times; // [s] of the measured runs, sorted
+
+    double percentile (double p) const; // nearest rank, p in [0, 100]
+    double median() const;
+};
+
+double Timing::percentile (double p) const {
+    if (this->times.empty())
+        return 0;
+    std::size_t rank = std::ceil(p / 100 * this->times.size());
+    return this->times[std::clamp<std::size_t>(rank, 1, this->times.size()) - 1];
+}
+
+double Timing::median () const {
+    return this->percentile(50);
+}
+
+Timing measure (int warmups, int repeats, std::function <void()> run, double min_sample = 0) {
+    // the warmup runs only fill the caches and fault in the memory
+    for (int w = 0; w < warmups; w++)
+        run();
+
+    // short runs are repeated within a sample until it takes at least min_sample [s] -
+    // a sample is the mean of its runs, so the timer resolution and the jitter do not dominate
+    auto sample = [&](int iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            run();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count();
+    };
+    int iterations = 1;
+    for (double time = 0; min_sample > 0 && (time = sample(iterations)) < min_sample && iterations < (1 << 20); )
+        iterations = std::min<double>(1 << 20, iterations * std::clamp(1.2 * min_sample / std::max(time, 1e-9), 2.0, 100.0));
+
+    Timing timing;
+    for (int r = 0; r < repeats; r++)
+        timing.times.push_back(sample(iterations) / iterations);
+
+    std::sort(timing.times.begin(), timing.times.end());
+    return timing;
+}
+
+double median_time (int repeats, std::function <void()> run) {
+    return measure(1, repeats, run).median();
+}
+
+void reset_peak_rss () {
+    // Linux: clears the VmHWM of the process (ignored where it is not supported)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+}
+
+std::size_t peak_rss () {
+    // [B] - VmHWM since the last reset, the peak of the whole run where /proc is not available
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+        if (line.starts_with("VmHWM:"))
+            return std::stoull(line.substr(6)) * 1024;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return std::size_t(usage.ru_maxrss) * 1024;
+}
+
+bool is_topological_order (IntGraphView graph, const std::vector <int> &order) {
+    std::vector <int> position(graph.num_vertices(), -1);
+    for (int i = 0; i < (int)order.size(); i++)
+        position[order[i]] = i;
+
+    for (int v = 0; v < graph.num_vertices(); v++)
+        for (int adj : graph[v])
+            if (position[v] == -1 || position[v] >= position[adj])
+                return false;
+    return true;
+}
+
+
+void reorder_benchmark (const graph::IntGraph &original, int repeats) {
+    int original_sccs = graph::algorithm::scc(original).num_components;
+    bool acyclic = true;
+    try {
+        graph::algorithm::topological_sort(original);
+    }
+    catch (std::invalid_argument &e) {
+        acyclic = false;
+    }
+
+    std::cout << "\nVertices: " << original.num_vertices() << ", edges: " << original.num_edges() << "\n";
+    std::cout << "Median of " << repeats << " runs [s]\n\n";
+    printf("%-10s %10s %10s %10s %10s %10s\n", "ordering", "reorder", "dfs", "bfs", "scc", "ts");
+
+    std::vector <std::string> orderings = {"original", "bfs", "rcm", "degree", "gorder"};
+    for (const std::string &ordering : orderings) {
+        graph::IntGraph reordered;
+        graph::Permutation permutation;
+        double reorder_time = 0;
+        if (ordering == "original") {
+            std::vector <int> identity(original.num_vertices());
+            std::iota(identity.begin(), identity.end(), 0);
+            permutation = graph::Permutation(identity);
+            reordered = graph::algorithm::reorder(original, permutation, true);
+        }
+        else {
+            auto start = std::chrono::high_resolution_clock::now();
+            permutation = graph::algorithm::reorder_permutation(original, graph::ordering_from_string(ordering));
+            reordered = graph::algorithm::reorder(original, permutation, true);
+            auto stop = std::chrono::high_resolution_clock::now();
+            reorder_time = std::chrono::duration<double>(stop - start).count();
+        }
+
+        double dfs_time = median_time(repeats, [&] { graph::algorithm::search(reordered, true); });
+        double bfs_time = median_time(repeats, [&] { graph::algorithm::search(reordered, false); });
+        double scc_time = median_time(repeats, [&] { graph::algorithm::scc(reordered); });
+        double ts_time = acyclic ? median_time(repeats, [&] { graph::algorithm::topological_sort(reordered); }) : 0;
+
+        // the results in the original ids
+        graph::Components scc = graph::algorithm::scc(reordered);
+        std::vector <int> component_idx = permutation.original_values<int>(scc.component_idx);
+        bool valid = scc.num_components == original_sccs && (int)component_idx.size() == original.num_vertices();
+        if (acyclic) {
+            std::vector <int> order = permutation.original_vertices(graph::algorithm::topological_sort(reordered));
+            valid = valid && is_topological_order(original, order);
+        }
+
+        printf("%-10s %10.4f %10.4f %10.4f %10.4f ", ordering.c_str(), reorder_time, dfs_time, bfs_time, scc_time);
+        if (acyclic)
+            printf("%10.4f", ts_time);
+        else
+            printf("%10s", "-");
+        printf("%s\n", valid ? "" : "  INVALID RESULTS");
+    }
+}
+
+void msbfs_benchmark (const graph::IntGraph &original, int repeats) {
+    // evenly spaced sources - the baselines run on a prefix of them and are reported per source
+    int num_vertices = original.num_vertices();
+    int num_sources = std::min(num_vertices, 1024);
+    int num_baseline_sources = std::min(num_sources, 64);
+    std::vector <int> sources(num_sources);
+    for (int i = 0; i < num_sources; i++)
+        sources[i] = (long long)i * num_vertices / num_sources;
+    std::span <const int> baseline_sources = std::span<const int>(sources).first(num_baseline_sources);
+
+    // correctness: the distances of the first batch against the single source searches
+    bool valid = true;
+    graph::MultiSourceDistances distances = graph::algorithm::multi_source_bfs<4>(original, baseline_sources);
+    std::vector <graph::SourceStats> stats = graph::algorithm::multi_source_bfs_stats<1>(original, baseline_sources);
+    for (int i = 0; i < num_baseline_sources; i++) {
+        std::vector <int> expected = graph::algorithm::bfs_distances(original, sources[i]);
+        valid = valid && std::ranges::equal(distances[i], expected);
+
+        long long distance_sum = 0;
+        for (int d : expected)
+            distance_sum += std::max(d, 0);
+        valid = valid && stats[i].distance_sum == distance_sum;
+    }
+
+    // all the lanes of the 256-wide batches against the 64-wide ones
+    std::vector <graph::SourceStats> narrow = graph::algorithm::multi_source_bfs_stats<1>(original, sources);
+    std::vector <graph::SourceStats> wide = graph::algorithm::multi_source_bfs_stats<4>(original, sources);
+    for (int i = 0; i < num_sources; i++)
+        valid = valid && narrow[i].reached == wide[i].reached && narrow[i].distance_sum == wide[i].distance_sum
+            && narrow[i].eccentricity == wide[i].eccentricity;
+
+    std::cout << "\nVertices: " << num_vertices << ", edges: " << original.num_edges() << ", sources: " << num_sources << "\n";
+    std::cout << "Median of " << repeats << " runs\n\n";
+    printf("%-22s %10s %14s %10s\n", "method", "time [s]", "sources / s", "speedup");
+
+    double baseline_rate = 0;
+    auto report = [&](std::string method, int num_searched, double time) {
+        double rate = num_searched / time;
+        if (baseline_rate == 0)
+            baseline_rate = rate;
+        printf("%-22s %10.4f %14.1f %9.1fx\n", method.c_str(), time, rate, rate / baseline_rate);
+    };
+
+    report("bfs_distances", num_baseline_sources, median_time(repeats, [&] {
+        for (int source : baseline_sources)
+            graph::algorithm::bfs_distances(original, source);
+    }));
+    report("search (whole graph)", num_baseline_sources, median_time(repeats, [&] {
+        for (int i = 0; i < num_baseline_sources; i++)
+            graph::algorithm::search(original, false);
+    }));
+    report("msbfs-64 stats", num_sources, median_time(repeats, [&] {
+        graph::algorithm::multi_source_bfs_stats<1>(original, sources);
+    }));
+    report("msbfs-256 stats", num_sources, median_time(repeats, [&] {
+        graph::algorithm::multi_source_bfs_stats<4>(original, sources);
+    }));
+    report("msbfs-256 distances", num_baseline_sources, median_time(repeats, [&] {
+        graph::algorithm::multi_source_bfs<4>(original, baseline_sources);
+    }));
+
+    if (!valid)
+        std::cout << "INVALID RESULTS\n";
+}
+void reach_benchmark (const graph::IntGraph &original, int repeats) {
+    int num_vertices = original.num_vertices();
+    std::size_t num_queries = 1 << 20;
+    int num_baseline_queries = std::min(num_vertices, 64);
+    std::mt19937 random(1);
+    std::uniform_int_distribution <int> vertex(0, num_vertices - 1);
+    std::vector <std::pair <int, int>> queries(num_queries);
+    for (auto &[u, v] : queries)
+        u = vertex(random), v = vertex(random);
+    std::span <const std::pair <int, int>> baseline_queries = std::span<const std::pair <int, int>>(queries).first(num_baseline_queries);
+
+    double build_time = median_time(repeats, [&] { graph::ReachabilityIndex index(original); });
+    graph::ReachabilityIndex index(original);
+
+    // correctness: the index against the bfs on a prefix of the queries
+    bool valid = true;
+    std::vector <std::uint8_t> answers = index.reaches(queries);
+    std::size_t positive = std::count(answers.begin(), answers.end(), 1);
+    for (int i = 0; i < num_baseline_queries; i++) {
+        auto [u, v] = queries[i];
+        bool expected = graph::algorithm::bfs_distances(original, u)[v] != -1;
+        valid = valid && answers[i] == expected && index.reaches(u, v) == expected;
+    }
+
+    std::cout << "\nVertices: " << num_vertices << ", edges: " << original.num_edges()
+              << ", components: " << index.num_components() << ", condensation edges: " << index.num_condensation_edges() << "\n";
+    std::cout << "Queries: " << num_queries << " (" << positive << " positive), index built in " << build_time << " s\n";
+    std::cout << "Median of " << repeats << " runs\n\n";
+    printf("%-22s %10s %14s %10s\n", "method", "time [s]", "queries / s", "speedup");
+
+    double baseline_rate = 0;
+    auto report = [&](std::string method, std::size_t num_answered, double time) {
+        double rate = num_answered / time;
+        if (baseline_rate == 0)
+            baseline_rate = rate;
+        printf("%-22s %10.4f %14.1f %9.1fx\n", method.c_str(), time, rate, rate / baseline_rate);
+    };
+
+    report("bfs per query", num_baseline_queries, median_time(repeats, [&] {
+        for (auto [u, v] : baseline_queries)
+            graph::algorithm::bfs_distances(original, u);
+    }));
+    report("index", num_queries, median_time(repeats, [&] {
+        for (auto [u, v] : queries)
+            index.reaches(u, v);
+    }));
+    report("index (batch)", num_queries, median_time(repeats, [&] {
+        index.reaches(queries);
+    }));
+
+    if (!valid)
+        std::cout << "INVALID RESULTS\n";
+}
+void compress_benchmark (const graph::IntGraph &original, int repeats) {
+    std::cout << "\nVertices: " << original.num_vertices() << ", edges: " << original.num_edges() << "\n";
+    std::cout << "Median of " << repeats << " runs [s] - CSR / compressed\n\n";
+    printf("%-10s %12s %12s %8s %10s %17s %17s %17s\n",
+           "ordering", "CSR [B]", "comp. [B]", "ratio", "B / edge", "dfs", "bfs", "scc");
+
+    std::vector <std::string> orderings = {"original", "bfs", "rcm", "gorder"};
+    for (const std::string &ordering : orderings) {
+        // the reordered graph has sorted lists - the CSR traverses them in the same order
+        std::vector <int> identity(original.num_vertices());
+        std::iota(identity.begin(), identity.end(), 0);
+        graph::Permutation permutation = ordering == "original"
+            ? graph::Permutation(identity)
+            : graph::algorithm::reorder_permutation(original, graph::ordering_from_string(ordering));
+        graph::IntGraph reordered = graph::algorithm::reorder(original, permutation);
+        graph::CompressedGraph compressed(reordered);
+
+        std::size_t csr_size = (reordered.num_vertices() + 1) * sizeof(std::size_t) + reordered.num_edges() * sizeof(int);
+        bool valid = compressed.num_edges() == reordered.num_edges();
+        for (bool depth_first : {true, false}) {
+            graph::SearchResult expected = graph::algorithm::search(reordered, depth_first);
+            graph::SearchResult result = graph::algorithm::search(compressed, depth_first);
+            valid = valid && result.order == expected.order && result.parent_idx == expected.parent_idx;
+        }
+        valid = valid && graph::algorithm::scc(compressed).component_idx == graph::algorithm::scc(reordered).component_idx;
+
+        auto times = [&](std::function <void()> csr, std::function <void()> comp) {
+            return std::make_pair(median_time(repeats, csr), median_time(repeats, comp));
+        };
+        auto [dfs_csr, dfs_comp] = times([&] { graph::algorithm::search(reordered, true); }, [&] { graph::algorithm::search(compressed, true); });
+        auto [bfs_csr, bfs_comp] = times([&] { graph::algorithm::search(reordered, false); }, [&] { graph::algorithm::search(compressed, false); });
+        auto [scc_csr, scc_comp] = times([&] { graph::algorithm::scc(reordered); }, [&] { graph::algorithm::scc(compressed); });
+
+        printf("%-10s %12zu %12zu %7.2fx %10.2f %8.4f/%8.4f %8.4f/%8.4f %8.4f/%8.4f%s\n",
+               ordering.c_str(), csr_size, compressed.size_bytes(), double(csr_size) / compressed.size_bytes(),
+               double(compressed.size_bytes()) / std::max<std::size_t>(reordered.num_edges(), 1),
+               dfs_csr, dfs_comp, bfs_csr, bfs_comp, scc_csr, scc_comp, valid ? "" : "  INVALID RESULTS");
+    }
+}
+
+
+void build_benchmark (const graph::IntGraph &original, int repeats) {
+    // every undirected edge once, in a random order (as in a generated or crawled edge list)
+    std::vector <std::pair <int, int>> edges;
+    for (int u = 0; u < original.num_vertices(); u++)
+        for (int v : original[u])
+            if (original.is_directed() || u <= v)
+                edges.push_back(std::make_pair(u, v));
+    std::shuffle(edges.begin(), edges.end(), std::mt19937(1));
+
+    int num_vertices = original.num_vertices();
+    bool directed = original.is_directed();
+    std::cout << "\nVertices: " << num_vertices << ", edges: " << edges.size() << "\n";
+    std::cout << "Median of " << repeats << " runs\n\n";
+    printf("%-24s %10s %14s %10s\n", "builder", "time [s]", "edges / s", "entries");
+
+    auto report = [&](std::string name, std::function <graph::IntGraph()> build) {
+        graph::IntGraph graph;
+        double time = median_time(repeats, [&] { graph = build(); });
+        printf("%-24s %10.4f %14.0f %10zu\n", name.c_str(), time, edges.size() / time, graph.num_edges());
+    };
+
+    report("add_edge + freeze", [&] {
+        graph::IntGraph graph(directed);
+        graph.push_vertices(num_vertices);
+        for (auto [u, v] : edges)
+            graph.add_edge(u, v);
+        graph.freeze();
+        return graph;
+    });
+    for (int num_threads : {1, 0})
+        for (bool deduplicate : {false, true}) {
+            std::string name = std::string("from_edges") + (deduplicate ? " dedup" : "") + (num_threads == 1 ? " (1 thread)" : "");
+            report(name, [&] {
+                graph::IntGraph graph;
+                graph.from_edges(directed, num_vertices, edges, graph::BuildOptions{.deduplicate = deduplicate, .num_threads = num_threads});
+                return graph;
+            });
+        }
+}
+
+
+void dynamic_benchmark (const graph::IntGraph &original, int repeats) {
+    // the edges in a random order: a DAG keeps the first half as the base graph and streams the rest,
+    // another graph streams all its edges into an empty base - the edges closing cycles are rejected
+    int num_vertices = original.num_vertices();
+    std::vector <std::pair <int, int>> edges;
+    for (int u = 0; u < num_vertices; u++)
+        for (int v : original[u])
+            edges.push_back(std::make_pair(u, v));
+    std::shuffle(edges.begin(), edges.end(), std::mt19937(1));
+
+    bool acyclic = original.is_directed();
+    try {
+        graph::algorithm::topological_sort(original);
+    }
+    catch (std::invalid_argument &e) {
+        acyclic = false;
+    }
+
+    std::size_t num_base = acyclic ? edges.size() / 2 : 0;
+    std::span <const std::pair <int, int>> base_edges = std::span<const std::pair <int, int>>(edges).first(num_base);
+    std::span <const std::pair <int, int>> inserts = std::span<const std::pair <int, int>>(edges).subspan(num_base);
+    graph::IntGraph base;
+    base.from_edges(true, num_vertices, base_edges, graph::BuildOptions{.with_in_edges = true});
+
+    // correctness: the order after every insert while the checks cost at most ~10^8 steps, then the final order
+    graph::DynamicTopologicalOrder order(base);
+    std::vector <std::vector <int>> accepted(num_vertices);
+    std::size_t num_checked = std::min<std::size_t>(inserts.size(), 100000000 / (num_vertices + edges.size() + 1) + 1);
+    std::size_t rejected = 0;
+    bool valid = true;
+    auto is_valid_order = [&]() -> bool {
+        std::vector <int> current(order.topological_order().begin(), order.topological_order().end());
+        bool valid_order = is_topological_order(base, current);
+        for (int u = 0; u < num_vertices; u++)
+            for (int v : accepted[u])
+                valid_order = valid_order && order.precedes(u, v);
+        return valid_order;
+    };
+    auto reaches = [&](int source, int target) -> bool {
+        // bfs over the base and the accepted edges
+        std::vector <bool> visited(num_vertices, false);
+        std::vector <int> queue = {source};
+        visited[source] = true;
+        for (std::size_t i = 0; i < queue.size(); i++)
+            for (std::span <const int> adjacent : {base[queue[i]], std::span<const int>(accepted[queue[i]])})
+                for (int adj : adjacent)
+                    if (!visited[adj]) {
+                        visited[adj] = true;
+                        queue.push_back(adj);
+                    }
+        return visited[target];
+    };
+    for (std::size_t i = 0; i < inserts.size(); i++) {
+        auto [u, v] = inserts[i];
+        bool inserted = order.add_edge(u, v);
+        if (inserted)
+            accepted[u].push_back(v);
+        else
+            rejected++;
+
+        if (i < num_checked)
+            valid = valid && (inserted ? is_valid_order() : reaches(v, u));
+    }
+    valid = valid && is_valid_order() && order.num_edges() == base.num_edges() + inserts.size() - rejected;
+
+    std::cout << "\nVertices: " << num_vertices << ", base edges: " << num_base << ", inserted edges: " << inserts.size()
+              << " (" << rejected << " rejected), checked after " << num_checked << " inserts\n";
+    std::cout << "Median of " << repeats << " runs\n\n";
+    printf("%-26s %10s %14s %10s\n", "method", "time [s]", "inserts / s", "speedup");
+
+    double baseline_rate = 0;
+    auto report = [&](std::string method, std::size_t num_inserted, double time) {
+        double rate = num_inserted / time;
+        if (baseline_rate == 0)
+            baseline_rate = rate;
+        printf("%-26s %10.4f %14.1f %9.1fx\n", method.c_str(), time, rate, rate / baseline_rate);
+    };
+
+    // the static order of a graph of the same size recomputed after every insert
+    report("topological_sort / insert", 1, median_time(repeats, [&] { graph::algorithm::topological_sort(base); }));
+    report("dynamic order", inserts.size(), median_time(repeats, [&] {
+        graph::DynamicTopologicalOrder dynamic(base);
+        for (auto [u, v] : inserts)
+            dynamic.add_edge(u, v);
+    }));
+
+    if (!valid)
+        std::cout << "INVALID RESULTS\n";
+}
+
+void unite_benchmark (const graph::IntGraph &original, int repeats) {
+    // every edge once, in a random order - the double cover (u -> 2u, v -> 2v + 1) is bipartite for any graph,
+    // so a concurrent unite which breaks the parities reports a false odd cycle on it
+    int num_vertices = original.num_vertices();
+    std::vector <std::pair <int, int>> edges, cover_edges;
+    for (int u = 0; u < num_vertices; u++)
+        for (int v : original[u])
+            if (original.is_directed() || u <= v) {
+                edges.push_back(std::make_pair(u, v));
+                cover_edges.push_back(std::make_pair(2 * u, 2 * v + 1));
+            }
+    std::shuffle(edges.begin(), edges.end(), std::mt19937(1));
+    std::shuffle(cover_edges.begin(), cover_edges.end(), std::mt19937(2));
+
+    auto unite = [](int n, const std::vector <std::pair <int, int>> &batch, parallel::Team &team) {
+        graph::ParityUnionFind uf(n);
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(batch.size(), thread_id, team.size());
+            for (std::size_t i = first; i < last; i++)
+                uf.unite(batch[i].first, batch[i].second);
+        });
+        return uf;
+    };
+
+    parallel::Team sequential(1);
+    graph::ParityUnionFind expected = unite(num_vertices, edges, sequential);
+    graph::ParityUnionFind expected_cover = unite(2 * num_vertices, cover_edges, sequential);
+
+    std::cout << "\nVertices: " << num_vertices << ", edges: " << edges.size() << ", components: " << expected.num_components()
+              << (expected.is_bipartite() ? ", bipartite" : ", NOT bipartite") << "\n";
+    std::cout << "Median of " << repeats << " runs, every run checked\n\n";
+    printf("%-10s %10s %14s %10s\n", "threads", "time [s]", "edges / s", "speedup");
+
+    bool valid = expected_cover.is_bipartite();
+    double baseline_time = 0;
+    for (int num_threads : {1, 2, 4, 8}) {
+        parallel::Team team(num_threads);
+        std::vector <double> times;
+        for (int r = 0; r < repeats; r++) {
+            auto start = std::chrono::steady_clock::now();
+            graph::ParityUnionFind uf = unite(num_vertices, edges, team);
+            times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            valid = valid && uf.num_components() == expected.num_components() && uf.is_bipartite() == expected.is_bipartite();
+
+            // the cover: bipartite, and every edge joins the two sides of the partition
+            graph::ParityUnionFind cover = unite(2 * num_vertices, cover_edges, team);
+            valid = valid && cover.is_bipartite() && cover.num_components() == expected_cover.num_components();
+            if (valid) {
+                std::vector <bool> red(2 * num_vertices, false);
+                for (int v : cover.bipartite_partition().first)
+                    red[v] = true;
+                for (auto [u, v] : cover_edges)
+                    valid = valid && red[u] != red[v];
+            }
+        }
+
+        std::sort(times.begin(), times.end());
+        double time = times[times.size() / 2];
+        if (baseline_time == 0)
+            baseline_time = time;
+        printf("%-10d %10.4f %14.0f %9.1fx\n", num_threads, time, edges.size() / time, baseline_time / time);
+    }
+
+    if (!valid)
+        std::cout << "INVALID RESULTS\n";
+}
+
+struct SuiteOptions {
+    std::string results_file;
+    int warmups = 1;
+    int repeats = 10;
+    std::vector <int> scales = {12, 14, 16};
+    std::vector <int> edge_factors; // the default matrix over the densities - the default of each model if empty
+    std::vector <std::string> graphs; // generator specs - the default matrix over `scales` if empty
+    std::string baseline_file;
+    double threshold = 0.1; // relative slowdown of the median reported as a regression
+    double min_sample = 0.01; // [s] - see `measure`
+    int min_repeats = 5; // fewer repeats give too wide percentiles to tell a regression from the noise
+    double min_time = 1e-3; // [s] - shorter baseline medians are not flagged
+};
+
+struct SuiteResult {
+    std::string graph;
+    std::string algorithm;
+    int vertices;
+    std::size_t edges; // adjacency entries
+    Timing timing;
+    std::size_t peak_rss; // [B]
+};
+
+std::vector <std::string> split (std::string text, char separator) {
+    std::vector <std::string> fields;
+    std::stringstream stream(text);
+    std::string field;
+    while (std::getline(stream, field, separator))
+        fields.push_back(field);
+    return fields;
+}
+
+void write_results (std::string file_name, const SuiteOptions &options, const std::vector <SuiteResult> &results) {
+    std::ofstream out(file_name);
+    if (!out)
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    bool csv = file_name.ends_with(".csv");
+    char buffer[512];
+    if (csv)
+        out << "graph,algorithm,vertices,edges,median,p10,p90,min,max,edges_per_s,peak_rss\n";
+    else
+        out << "{\"warmups\": " << options.warmups << ", \"repeats\": " << options.repeats << ", \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const SuiteResult &r = results[i];
+        const Timing &t = r.timing;
+        double median = t.median();
+        double rate = median > 0 ? r.edges / median : 0;
+        if (csv)
+            std::snprintf(buffer, sizeof(buffer), "%s,%s,%d,%zu,%.9f,%.9f,%.9f,%.9f,%.9f,%.1f,%zu\n",
+                          r.graph.c_str(), r.algorithm.c_str(), r.vertices, r.edges,
+                          median, t.percentile(10), t.percentile(90), t.times.front(), t.times.back(), rate, r.peak_rss);
+        else
+            std::snprintf(buffer, sizeof(buffer), "{\"graph\": \"%s\", \"algorithm\": \"%s\", \"vertices\": %d, \"edges\": %zu, "
+                          "\"median\": %.9f, \"p10\": %.9f, \"p90\": %.9f, \"min\": %.9f, \"max\": %.9f, \"edges_per_s\": %.1f, \"peak_rss\": %zu}%s\n",
+                          r.graph.c_str(), r.algorithm.c_str(), r.vertices, r.edges,
+                          median, t.percentile(10), t.percentile(90), t.times.front(), t.times.back(), rate, r.peak_rss,
+                          i + 1 < results.size() ? "," : "");
+        out << buffer;
+    }
+
+    if (!csv)
+        out << "]}\n";
+}
+
+std::map <std::pair <std::string, std::string>, std::map <std::string, std::string>> read_results (std::string file_name) {
+    // (graph, algorithm) -> fields of a results file written by `write_results` (JSON: one result per line)
+    std::ifstream in(file_name);
+    if (!in)
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    std::map <std::pair <std::string, std::string>, std::map <std::string, std::string>> results;
+    std::regex json_field("\"(\\w+)\": \"?([^\",}]*)\"?");
+    std::vector <std::string> csv_header;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::map <std::string, std::string> fields;
+        if (line.starts_with("{\"graph\"")) {
+            for (auto it = std::sregex_iterator(line.begin(), line.end(), json_field); it != std::sregex_iterator(); it++)
+                fields[(*it)[1]] = (*it)[2];
+        }
+        else if (line.starts_with("graph,"))
+            csv_header = split(line, ',');
+        else if (!csv_header.empty()) {
+            std::vector <std::string> values = split(line, ',');
+            for (std::size_t i = 0; i < std::min(values.size(), csv_header.size()); i++)
+                fields[csv_header[i]] = values[i];
+        }
+
+        if (fields.contains("graph") && fields.contains("algorithm") && fields.contains("median"))
+            results[std::make_pair(fields["graph"], fields["algorithm"])] = fields;
+    }
+    return results;
+}
+
+int suite_benchmark (const SuiteOptions &options) {
+    std::vector <std::string> graphs = options.graphs;
+    if (graphs.empty())
+        for (int scale : options.scales) {
+            // the grid has a fixed degree (edge factor 0) - it is generated once per scale
+            std::vector <std::pair <std::string, int>> models = {
+                {"rmat:%d:%d:D", 16}, {"rmat:%d:%d:U", 16}, {"er:%d:%d:D", 8}, {"grid:%d:%d:U", 0}, {"dag:%d:%d:D", 8}
+            };
+            for (auto [spec, default_factor] : models) {
+                std::vector <int> edge_factors = options.edge_factors.empty() || default_factor == 0 ? std::vector<int>{default_factor} : options.edge_factors;
+                for (int edge_factor : edge_factors) {
+                    char buffer[64];
+                    std::snprintf(buffer, sizeof(buffer), spec.c_str(), scale, edge_factor);
+                    graphs.push_back(buffer);
+                }
+            }
+        }
+
+    auto baseline = options.baseline_file.empty() ? decltype(read_results("")){} : read_results(options.baseline_file);
+
+    std::cout << "\nWarmups: " << options.warmups << ", repeats: " << options.repeats << "\n\n";
+    printf("%-16s %-6s %10s %10s %10s %14s %10s %10s\n", "graph", "alg.", "median [s]", "p10 [s]", "p90 [s]", "edges / s", "RSS [MiB]", "baseline");
+
+    std::vector <SuiteResult> results;
+    int regressions = 0;
+    for (const std::string &spec : graphs) {
+        graph::IntGraph graph = graph::GraphGenerator(graph::generator_from_string(spec)).graph();
+
+        bool acyclic = true;
+        try {
+            graph::algorithm::topological_sort(graph);
+        }
+        catch (std::invalid_argument &e) {
+            acyclic = false;
+        }
+
+        bool bipartite = true;
+        try {
+            graph::algorithm::bipartite_partition(graph);
+        }
+        catch (std::invalid_argument &e) {
+            bipartite = false;
+        }
+
+        // ts and bi end at the first cycle / odd cycle - they are timed on the graphs they accept only
+        std::vector <std::pair <std::string, std::function <void()>>> algorithms = {
+            {"dfs", [&] { graph::algorithm::search(graph, true); }},
+            {"bfs", [&] { graph::algorithm::search(graph, false); }},
+            {"scc", [&] { graph::algorithm::scc(graph); }}
+        };
+        if (acyclic)
+            algorithms.push_back({"ts", [&] { graph::algorithm::topological_sort(graph); }});
+        if (bipartite)
+            algorithms.push_back({"bi", [&] { graph::algorithm::bipartite_partition(graph); }});
+
+        for (auto &[name, run] : algorithms) {
+            reset_peak_rss();
+            SuiteResult result = {.graph = spec, .algorithm = name, .vertices = graph.num_vertices(), .edges = graph.num_edges(),
+                                  .timing = measure(options.warmups, options.repeats, run, options.min_sample), .peak_rss = peak_rss()};
+            double median = result.timing.median();
+
+            // a regression: the median slower by more than the threshold and the p10 above the baseline p90,
+            // so that the difference is not within the run to run noise of either measurement -
+            // with enough repeats for the percentiles and a baseline long enough to be timed reliably
+            std::string comparison = "-";
+            auto it = baseline.find(std::make_pair(spec, name));
+            if (it != baseline.end()) {
+                double base_median = std::stod(it->second["median"]);
+                double base_p10 = it->second.contains("p10") ? std::stod(it->second["p10"]) : base_median;
+                double base_p90 = it->second.contains("p90") ? std::stod(it->second["p90"]) : base_median;
+                char buffer[64];
+                std::snprintf(buffer, sizeof(buffer), "%.2fx", base_median > 0 ? median / base_median : 0);
+                comparison = buffer;
+                bool measurable = options.repeats >= options.min_repeats && base_median >= options.min_time;
+                if (!measurable)
+                    comparison += " ~";
+                else if (median > base_median * (1 + options.threshold) && result.timing.percentile(10) > base_p90) {
+                    comparison += " REGRESSION";
+                    regressions++;
+                }
+                else if (median < base_median * (1 - options.threshold) && result.timing.percentile(90) < base_p10)
+                    comparison += " faster";
+            }
+
+            printf("%-16s %-6s %10.6f %10.6f %10.6f %14.0f %10.1f %10s\n", spec.c_str(), name.c_str(), median,
+                   result.timing.percentile(10), result.timing.percentile(90), median > 0 ? result.edges / median : 0,
+                   double(result.peak_rss) / (1 << 20), comparison.c_str());
+            results.push_back(std::move(result));
+        }
+    }
+
+    write_results(options.results_file, options, results);
+    std::cout << "\nResults saved: " << options.results_file << "\n";
+    if (!options.baseline_file.empty())
+        std::cout << "Regressions against " << options.baseline_file << ": " << regressions << "\n";
+    return regressions > 0 ? 2 : 0;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Error: Invalid arguments\n");
+        return 1;
+    }
+
+    std::string benchmark = argv[1];
+    std::string file_name = argv[2];
+    if (benchmark == "suite") {
+        SuiteOptions options;
+        options.results_file = file_name;
+        try {
+            for (int i = 3; i < argc; i++) {
+                std::string argument = argv[i];
+                std::string value = argument.substr(argument.find('=') + 1);
+                if (argument.starts_with("--repeats="))
+                    options.repeats = std::max(1, std::stoi(value));
+                else if (argument.starts_with("--warmups="))
+                    options.warmups = std::max(0, std::stoi(value));
+                else if (argument.starts_with("--scales=")) {
+                    options.scales.clear();
+                    for (std::string scale : split(value, ','))
+                        options.scales.push_back(std::stoi(scale));
+                }
+                else if (argument.starts_with("--edge-factors=")) {
+                    options.edge_factors.clear();
+                    for (std::string edge_factor : split(value, ','))
+                        options.edge_factors.push_back(std::stoi(edge_factor));
+                }
+                else if (argument.starts_with("--graphs="))
+                    options.graphs = split(value, ',');
+                else if (argument.starts_with("--baseline="))
+                    options.baseline_file = value;
+                else if (argument.starts_with("--threshold="))
+                    options.threshold = std::stod(value);
+                else if (argument.starts_with("--min-sample="))
+                    options.min_sample = std::stod(value);
+                else if (argument.starts_with("--min-repeats="))
+                    options.min_repeats = std::stoi(value);
+                else if (argument.starts_with("--min-time="))
+                    options.min_time = std::stod(value);
+                else
+                    throw std::invalid_argument("Invalid option (" + argument + ")");
+            }
+            return suite_benchmark(options);
+        }
+        catch (std::exception& e) {
+            std::cout << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    int repeats = argc > 3 ? std::stoi(argv[3]) : 5;
+
+    graph::IntGraph original;
+    try {
+        if (graph::is_generator_spec(file_name))
+            original = graph::GraphGenerator(graph::generator_from_string(file_name)).graph(graph::BuildOptions{.with_in_edges = true});
+        else
+            original.from_file(file_name, true);
+    }
+    catch (std::exception& e) {
+        std::cout << "Error: Could not read '" << file_name << "'!\n\t";
+        std::cout << e.what() << "\n";
+        std::exit(1);
+    }
+
+    if (benchmark == "reorder")
+        reorder_benchmark(original, repeats);
+    else if (benchmark == "msbfs")
+        msbfs_benchmark(original, repeats);
+    else if (benchmark == "reach")
+        reach_benchmark(original, repeats);
+    else if (benchmark == "compress")
+        compress_benchmark(original, repeats);
+    else if (benchmark == "build")
+        build_benchmark(original, repeats);
+    else if (benchmark == "dynamic")
+        dynamic_benchmark(original, repeats);
+    else if (benchmark == "unite")
+        unite_benchmark(original, repeats);
+    else {
+        std::cout << "Error: Invalid value of `benchmark` - must be ['reorder', 'msbfs', 'reach', 'compress', 'build', 'dynamic', 'unite', 'suite']!\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "graph.hpp"
+#include "parallel.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    struct _group_varint {
+        // Every neighbour list is stored as its degree (LEB128 varint) followed by groups of 4 values:
+        // a control byte (2 bits per value: its length in bytes - 1) and the little-endian value bytes
+        // The values are gaps: zigzag(first neighbour - vertex), then the differences of the sorted neighbours
+        // A group decodes without data-dependent branches - 4 masked unaligned loads (the layout of
+        // Google's group varint, which a shuffle-based SIMD decoder reads as well)
+        static constexpr std::size_t padding = 4; // bytes after the last list - the loads may read past it
+
+        static std::size_t varint_size (std::uint32_t value);
+        static std::size_t value_size (std::uint32_t value); // 1 - 4 bytes
+        static std::uint32_t zigzag (int value);
+        static int unzigzag (std::uint32_t value);
+        static std::size_t encoded_size (std::span <const int> sorted, int vertex);
+        static std::uint8_t* encode (std::span <const int> sorted, int vertex, std::uint8_t *out);
+    };
+
+
+
+    class CompressedGraph {
+        // Read-only adjacency store with delta + group varint encoded neighbour lists (WebGraph-like)
+        // Sorted (e.g. reordered - reorder.hpp) neighbour lists of a graph with locality compress
+        // best: most gaps take a single byte. The lists are decoded while iterated, so the
+        // algorithms visit the neighbours in ascending order
+        // Built from an IntGraphView - a GraphSnapshot view keeps the uncompressed graph out of memory
+        private:
+            bool directed = false;
+            int n_vertices = 0;
+            std::size_t n_edges = 0;
+            std::vector <std::uint64_t> offsets; // vertex -> first byte of its list
+            std::vector <std::uint8_t> bytes;
+
+        public:
+            class Iterator {
+                // decodes a group of 4 neighbours at once
+                private:
+                    const std::uint8_t *data = nullptr; // the next group
+                    int left = 0; // neighbours not yet passed, including the current one
+                    int index = 0; // of the current neighbour in the group
+                    int previous = 0; // the last decoded neighbour
+                    int group[4];
+
+                    void decode_group (bool first);
+
+                public:
+                    Iterator() = default;
+                    Iterator (const std::uint8_t *list, int vertex);
+
+                    int operator * () const;
+                    Iterator& operator ++ ();
+                    bool operator == (std::default_sentinel_t) const;
+            };
+
+            struct Neighbours {
+                const std::uint8_t *list;
+                int vertex;
+
+                Iterator begin() const;
+                std::default_sentinel_t end() const;
+            };
+
+            CompressedGraph() = default;
+            CompressedGraph (IntGraphView graph, int num_threads = 0);
+            ~CompressedGraph() = default;
+
+            bool is_directed() const;
+            int num_vertices() const;
+            std::size_t num_edges() const;
+            std::size_t size_bytes() const; // the offsets and the lists
+            int out_deg (int vertex) const;
+            Neighbours operator [] (int vertex) const;
+    };
+
+
+
+    namespace algorithm {
+        SearchResult search (const CompressedGraph &graph, bool depth_first, bool with_times = false);
+        Components scc (const CompressedGraph &graph);
+        std::pair<std::vector <int>, std::vector <int>> bipartite_partition (const CompressedGraph &graph);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// group varint coding
+std::size_t _group_varint::varint_size (std::uint32_t value) {
+    std::size_t size = 1;
+    for (; value >= 0x80; value >>= 7)
+        size++;
+    return size;
+}
+
+std::size_t _group_varint::value_size (std::uint32_t value) {
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+std::uint32_t _group_varint::zigzag (int value) {
+    return (std::uint32_t(value) << 1) ^ std::uint32_t(value >> 31);
+}
+
+int _group_varint::unzigzag (std::uint32_t value) {
+    return int(value >> 1) ^ -int(value & 1);
+}
+
+std::size_t _group_varint::encoded_size (std::span <const int> sorted, int vertex) {
+    std::size_t size = _group_varint::varint_size(sorted.size()) + (sorted.size() + 3) / 4;
+    for (std::size_t i = 0; i < sorted.size(); i++)
+        size += _group_varint::value_size(i == 0 ? _group_varint::zigzag(sorted[0] - vertex) : sorted[i] - sorted[i - 1]);
+    return size;
+}
+
+std::uint8_t* _group_varint::encode (std::span <const int> sorted, int vertex, std::uint8_t *out) {
+    for (std::uint32_t degree = sorted.size(); ; degree >>= 7) {
+        if (degree < 0x80) {
+            *out++ = degree;
+            break;
+        }
+        *out++ = (degree & 0x7f) | 0x80;
+    }
+
+    for (std::size_t first = 0; first < sorted.size(); first += 4) {
+        std::uint8_t &control = *out++;
+        control = 0;
+        for (std::size_t i = first; i < std::min(first + 4, sorted.size()); i++) {
+            std::uint32_t value = i == 0 ? _group_varint::zigzag(sorted[0] - vertex) : sorted[i] - sorted[i - 1];
+            std::size_t size = _group_varint::value_size(value);
+            control |= (size - 1) << (2 * (i - first));
+            for (std::size_t b = 0; b < size; b++, value >>= 8)
+                *out++ = value & 0xff;
+        }
+    }
+
+    return out;
+}
+
+
+// CompressedGraph iterator
+CompressedGraph::Iterator::Iterator (const std::uint8_t *list, int vertex) {
+    std::uint32_t degree = 0;
+    for (int shift = 0; ; shift += 7) {
+        std::uint8_t byte = *list++;
+        degree |= std::uint32_t(byte & 0x7f) << shift;
+        if (byte < 0x80)
+            break;
+    }
+
+    this->data = list;
+    this->left = degree;
+    this->previous = vertex;
+    if (this->left > 0)
+        this->decode_group(true);
+}
+
+void CompressedGraph::Iterator::decode_group (bool first) {
+    // the values past the end of the list are decoded as well (from the padding) - they are never read
+    static constexpr std::uint32_t masks[4] = {0xff, 0xffff, 0xffffff, 0xffffffff};
+    std::uint8_t control = *this->data++;
+    int num_values = std::min(this->left, 4);
+    std::uint32_t value = this->previous; // unsigned - the values past the end may overflow
+    for (int i = 0; i < 4; i++) {
+        int size = ((control >> (2 * i)) & 3) + 1;
+        std::uint32_t word;
+        std::memcpy(&word, this->data, sizeof(word));
+        word &= masks[size - 1];
+        // the first value of a list is relative to the vertex and may be negative
+        value += first && i == 0 ? std::uint32_t(_group_varint::unzigzag(word)) : word;
+        this->group[i] = value;
+        this->data += i < num_values ? size : 0;
+    }
+    this->previous = this->group[3];
+    this->index = 0;
+}
+
+int CompressedGraph::Iterator::operator* () const {
+    return this->group[this->index];
+}
+
+CompressedGraph::Iterator& CompressedGraph::Iterator::operator++ () {
+    this->left--;
+    if (++this->index == 4 && this->left > 0)
+        this->decode_group(false);
+    return *this;
+}
+
+bool CompressedGraph::Iterator::operator== (std::default_sentinel_t) const {
+    return this->left == 0;
+}
+
+CompressedGraph::Iterator CompressedGraph::Neighbours::begin () const {
+    return Iterator(this->list, this->vertex);
+}
+
+std::default_sentinel_t CompressedGraph::Neighbours::end () const {
+    return std::default_sentinel;
+}
+
+
+// CompressedGraph container
+CompressedGraph::CompressedGraph (IntGraphView graph, int num_threads) {
+    // two passes over the lists: the encoded sizes (their prefix sums are the offsets), then the encoding
+    this->directed = graph.is_directed();
+    this->n_vertices = graph.num_vertices();
+    this->n_edges = 0;
+    this->offsets.assign(this->n_vertices + 1, 0);
+
+    parallel::Team team(num_threads);
+    std::vector <std::size_t> edges(team.size(), 0);
+    auto for_each_list = [&](int thread_id, auto encode) {
+        std::vector <int> sorted;
+        auto [first, last] = parallel::chunk(this->n_vertices, thread_id, team.size());
+        for (int v = first; v < (int)last; v++) {
+            std::span <const int> adjacent = graph[v];
+            sorted.assign(adjacent.begin(), adjacent.end());
+            std::sort(sorted.begin(), sorted.end());
+            encode(v, sorted);
+        }
+    };
+
+    team.run([&](int thread_id) {
+        for_each_list(thread_id, [&](int v, std::span <const int> sorted) {
+            this->offsets[v + 1] = _group_varint::encoded_size(sorted, v);
+            edges[thread_id] += sorted.size();
+        });
+    });
+    parallel::partial_sum(team, this->offsets.begin(), this->offsets.end());
+    for (std::size_t count : edges)
+        this->n_edges += count;
+
+    this->bytes.resize(this->offsets.back() + _group_varint::padding, 0);
+    team.run([&](int thread_id) {
+        for_each_list(thread_id, [&](int v, std::span <const int> sorted) {
+            _group_varint::encode(sorted, v, this->bytes.data() + this->offsets[v]);
+        });
+    });
+}
+
+bool CompressedGraph::is_directed () const {
+    return this->directed;
+}
+
+int CompressedGraph::num_vertices () const {
+    return this->n_vertices;
+}
+
+std::size_t CompressedGraph::num_edges () const {
+    return this->n_edges;
+}
+
+std::size_t CompressedGraph::size_bytes () const {
+    return this->offsets.size() * sizeof(std::uint64_t) + this->bytes.size();
+}
+
+int CompressedGraph::out_deg (int vertex) const {
+    const std::uint8_t *list = this->bytes.data() + this->offsets[vertex];
+    std::uint32_t degree = 0;
+    for (int shift = 0; ; shift += 7) {
+        std::uint8_t byte = *list++;
+        degree |= std::uint32_t(byte & 0x7f) << shift;
+        if (byte < 0x80)
+            return degree;
+    }
+}
+
+CompressedGraph::Neighbours CompressedGraph::operator[] (int vertex) const {
+    return Neighbours{.list = this->bytes.data() + this->offsets[vertex], .vertex = vertex};
+}
+
+
+// algorithms on the compressed lists - the same implementations as for IntGraphView
+SearchResult algorithm::search (const CompressedGraph &graph, bool depth_first, bool with_times) {
+    if (depth_first)
+        return with_times ? algorithm::_search<Stack, true>(graph) : algorithm::_search<Stack, false>(graph);
+    return with_times ? algorithm::_search<Queue, true>(graph) : algorithm::_search<Queue, false>(graph);
+}
+
+Components algorithm::scc (const CompressedGraph &graph) {
+    return algorithm::_scc(graph);
+}
+
+std::pair<std::vector <int>, std::vector <int>> algorithm::bipartite_partition (const CompressedGraph &graph) {
+    return algorithm::_bipartite_partition(graph);
+}
@@ -0,0 +1,733 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "graph.hpp"
+#include "instrument.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    /*
+    Transports of the distributed bfs - a policy passed as a template parameter:
+        Transport (int size) - all the endpoints, created before the workers are forked
+        void spawned (int rank, pid_t pid) - called by worker 0 (the parent) right after forking worker `rank`
+        void attach (int rank) - called once in every worker, releases the endpoints of the others
+        int rank() const, int size() const
+        void all_to_all (batches &send, batches &receive) - send[w] goes to worker w, receive[w] is
+            what worker w sent to the caller; every worker calls it in the same round, send[rank] is moved
+    The messages are 64-bit words
+    */
+    using _batches = std::vector <std::vector <std::uint64_t>>;
+
+    class SocketTransport {
+        // a Unix stream socket pair for every pair of workers (at most ~30 workers: 2 descriptors per pair)
+        // the batches are framed by their word count and exchanged with non-blocking sends and receives
+        // multiplexed by poll, so two workers sending large batches to each other do not deadlock
+        private:
+            int n_workers;
+            int worker_rank = -1;
+            std::vector <std::vector <int>> sockets; // sockets[i][j]: the end of worker i connected to worker j
+
+        public:
+            SocketTransport (int size);
+            SocketTransport (const SocketTransport&) = delete;
+            SocketTransport& operator = (const SocketTransport&) = delete;
+            ~SocketTransport();
+
+            void spawned (int rank, pid_t pid);
+            void attach (int rank);
+            int rank() const;
+            int size() const;
+            void all_to_all (_batches &send, _batches &receive);
+    };
+
+    class SharedMemoryTransport {
+        // an anonymous shared mapping with a mailbox of `capacity` words for every ordered pair of workers
+        // Batches larger than a mailbox are exchanged in rounds: every worker fills its outgoing mailboxes,
+        // a process-shared barrier, every worker drains its incoming mailboxes, a barrier
+        // The barrier polls for a worker which died: worker 0 (the parent) checks its children, the children
+        // check their parent - the first to notice sets a shared flag and every waiting worker throws
+        private:
+            struct _mailbox_s {
+                std::uint64_t count; // words in this round
+                std::uint64_t more; // the batch continues in the next round
+            };
+
+            struct _control_s {
+                std::atomic <std::uint32_t> arrived; // at the barrier in this generation
+                std::atomic <std::uint32_t> generation;
+                std::atomic <std::uint32_t> failed;
+            };
+
+            int n_workers;
+            int worker_rank = -1;
+            std::size_t capacity;
+            std::size_t mailbox_bytes;
+            std::size_t header_bytes; // the control block and the pids of the workers
+            char *region = nullptr;
+            std::size_t region_bytes;
+
+            _control_s* control();
+            pid_t* pids();
+            _mailbox_s* mailbox (int from, int to);
+            void barrier();
+            void check_workers();
+
+        public:
+            SharedMemoryTransport (int size);
+            SharedMemoryTransport (const SharedMemoryTransport&) = delete;
+            SharedMemoryTransport& operator = (const SharedMemoryTransport&) = delete;
+            ~SharedMemoryTransport();
+
+            void spawned (int rank, pid_t pid);
+            void attach (int rank);
+            int rank() const;
+            int size() const;
+            void all_to_all (_batches &send, _batches &receive);
+    };
+
+
+
+    struct LevelTraffic {
+        // one bfs level (distance from the root), summed over the searches from all the roots
+        std::size_t frontier = 0; // vertices expanded
+        std::size_t messages = 0; // (vertex, parent) candidates sent to other workers
+        std::size_t bytes = 0; // sent to other workers, the exchange of the frontier ranks included
+    };
+
+    struct DistributedResult {
+        SearchResult search;
+        std::vector <LevelTraffic> levels;
+        std::size_t rounds = 0; // all-to-all rounds of every worker
+    };
+
+
+
+    namespace algorithm {
+        // `_` prefixed members should be considered private
+
+        // bfs distributed across worker processes with a 1D partition of the vertices
+        // Worker w owns the vertices [w * block, (w + 1) * block) and reads the adjacency of its own vertices only
+        // (the workers are forked after loading, so the graph is shared copy-on-write instead of being sent)
+        // Every level is two all-to-all rounds:
+        //  - the owners of the frontier send (vertex, parent, parent rank) candidates to the owners of the neighbours,
+        //    which keep the minimal rank - the rank of `parallel_bfs`: (parent's search order position, edge position)
+        //  - the owners exchange the sorted ranks of their new vertices, from which every worker computes
+        //    the search order positions of its own new vertices (and the next root, if the level is empty)
+        // The search order and the parent array are reduced to worker 0 at the end -
+        // the same search order and search tree as `search(graph, false)`
+        // A root without out-edges is a search of its own, so the roots are picked in runs: the exchange of the ranks
+        // also carries the smallest unvisited vertex with out-edges of every worker (the next real root R) and the number
+        // of its unvisited vertices below it - those below R are placed in the search order without further rounds
+        struct _dbfs_s {
+            // state of one worker
+            static constexpr std::uint64_t unvisited = UINT64_MAX;
+
+            int num_vertices;
+            int block;
+            int first, last; // the own vertices
+            std::vector <std::uint64_t> parent_rank; // of the own vertices
+            std::vector <int> parent_idx;
+            std::vector <int> position; // in the search order
+            std::vector <int> frontier; // own vertices of the current level, in the search order
+            int cursor; // the own vertices below it are visited
+            int active; // the own vertices below it are visited or have no out-edges
+            std::size_t isolated; // unvisited own vertices below `active`
+            std::vector <LevelTraffic> levels;
+            std::size_t rounds = 0;
+        };
+
+        // [the smallest unvisited own vertex with out-edges (num_vertices if none), unvisited own vertices below it]
+        std::vector <std::uint64_t> _dbfs_candidate (IntGraphView graph, _dbfs_s &ds);
+        // places the roots without out-edges below the next root in the search order - returns the next root
+        int _dbfs_next_root (_dbfs_s &ds, const _batches &receive, int me, std::size_t &size);
+
+        template <typename Transport>
+        void _dbfs_exchange (Transport &transport, _dbfs_s &ds, _batches &send, _batches &receive, std::size_t depth);
+
+        template <typename Transport>
+        void _dbfs_worker (IntGraphView graph, Transport &transport, _dbfs_s &ds);
+
+        // the positions and parents of the own vertices followed by the level traffic, sent to worker 0
+        template <typename Transport>
+        DistributedResult _dbfs_reduce (Transport &transport, _dbfs_s &ds);
+
+        template <typename Transport>
+        DistributedResult distributed_bfs (IntGraphView graph, int num_workers);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// SocketTransport
+SocketTransport::SocketTransport (int size) {
+    if (size < 1)
+        throw std::invalid_argument("Error: The number of workers must be positive");
+
+    this->n_workers = size;
+    this->sockets.assign(size, std::vector<int>(size, -1));
+    for (int i = 0; i < size; i++)
+        for (int j = i + 1; j < size; j++) {
+            int pair[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0)
+                throw std::runtime_error("Could not create a socket pair: " + std::string(std::strerror(errno)));
+            this->sockets[i][j] = pair[0];
+            this->sockets[j][i] = pair[1];
+        }
+}
+
+SocketTransport::~SocketTransport () {
+    for (std::vector <int> &row : this->sockets)
+        for (int fd : row)
+            if (fd >= 0)
+                ::close(fd);
+}
+
+void SocketTransport::spawned (int, pid_t) {
+    // a dead worker closes its sockets - the others notice it without its pid
+}
+
+void SocketTransport::attach (int rank) {
+    this->worker_rank = rank;
+    for (int i = 0; i < this->n_workers; i++)
+        for (int j = 0; j < this->n_workers; j++)
+            if (i != rank && this->sockets[i][j] >= 0) {
+                ::close(this->sockets[i][j]);
+                this->sockets[i][j] = -1;
+            }
+
+    for (int fd : this->sockets[rank])
+        if (fd >= 0)
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+int SocketTransport::rank () const {
+    return this->worker_rank;
+}
+
+int SocketTransport::size () const {
+    return this->n_workers;
+}
+
+void SocketTransport::all_to_all (_batches &send, _batches &receive) {
+    int me = this->worker_rank;
+    receive.resize(this->n_workers);
+    receive[me] = std::move(send[me]);
+    send[me].clear();
+
+    // a frame: the word count, then the words - offsets in bytes of the frame
+    struct _peer_s {
+        int worker;
+        std::uint64_t out_count, in_count;
+        std::size_t out_done = 0, in_done = 0;
+    };
+    std::vector <_peer_s> peers;
+    for (int w = 0; w < this->n_workers; w++)
+        if (w != me) {
+            peers.push_back(_peer_s{.worker = w, .out_count = send[w].size(), .in_count = 0});
+            receive[w].clear();
+        }
+
+    std::vector <pollfd> fds(peers.size());
+    while (true) {
+        std::size_t active = 0;
+        for (std::size_t p = 0; p < peers.size(); p++) {
+            const _peer_s &peer = peers[p];
+            bool sending = peer.out_done < 8 * (peer.out_count + 1);
+            bool receiving = peer.in_done < 8 || peer.in_done < 8 * (peer.in_count + 1);
+            fds[p] = pollfd{.fd = this->sockets[me][peer.worker], .events = short((sending ? POLLOUT : 0) | (receiving ? POLLIN : 0)), .revents = 0};
+            active += sending || receiving;
+        }
+        if (active == 0)
+            return;
+
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("Could not poll the workers: " + std::string(std::strerror(errno)));
+        }
+
+        for (std::size_t p = 0; p < peers.size(); p++) {
+            _peer_s &peer = peers[p];
+            int fd = fds[p].fd;
+            if (fds[p].revents & POLLOUT) {
+                iovec parts[2] = {
+                    {.iov_base = &peer.out_count, .iov_len = 8},
+                    {.iov_base = send[peer.worker].data(), .iov_len = 8 * peer.out_count}
+                };
+                // skip what was sent
+                std::size_t skip = peer.out_done;
+                int first_part = skip < 8 ? 0 : 1;
+                parts[first_part].iov_base = static_cast<char*>(parts[first_part].iov_base) + (first_part == 0 ? skip : skip - 8);
+                parts[first_part].iov_len -= first_part == 0 ? skip : skip - 8;
+                msghdr message = {};
+                message.msg_iov = parts + first_part;
+                message.msg_iovlen = 2 - first_part;
+                ssize_t sent = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    throw std::runtime_error("Could not send to worker " + std::to_string(peer.worker) + ": " + std::strerror(errno));
+                peer.out_done += std::max<ssize_t>(sent, 0);
+            }
+
+            if (fds[p].revents & (POLLIN | POLLHUP | POLLERR)) {
+                char *target;
+                std::size_t wanted;
+                if (peer.in_done < 8) {
+                    target = reinterpret_cast<char*>(&peer.in_count) + peer.in_done;
+                    wanted = 8 - peer.in_done;
+                }
+                else {
+                    target = reinterpret_cast<char*>(receive[peer.worker].data()) + (peer.in_done - 8);
+                    wanted = 8 * (peer.in_count + 1) - peer.in_done;
+                }
+                ssize_t received = wanted > 0 ? ::recv(fd, target, wanted, 0) : 0;
+                if (received == 0 && wanted > 0)
+                    throw std::runtime_error("Worker " + std::to_string(peer.worker) + " closed the connection");
+                if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    throw std::runtime_error("Could not receive from worker " + std::to_string(peer.worker) + ": " + std::strerror(errno));
+
+                bool had_header = peer.in_done >= 8;
+                peer.in_done += std::max<ssize_t>(received, 0);
+                if (!had_header && peer.in_done >= 8)
+                    receive[peer.worker].resize(peer.in_count);
+            }
+        }
+    }
+}
+
+
+// SharedMemoryTransport
+SharedMemoryTransport::SharedMemoryTransport (int size) {
+    if (size < 1)
+        throw std::invalid_argument("Error: The number of workers must be positive");
+
+    // 64 MiB of mailboxes in total, at least 4096 words each
+    this->n_workers = size;
+    this->capacity = std::max<std::size_t>(4096, (std::size_t(64) << 20) / 8 / (std::size_t(size) * size));
+    this->mailbox_bytes = sizeof(_mailbox_s) + 8 * this->capacity;
+    this->header_bytes = 64 + (std::size_t(size) * sizeof(pid_t) + 63) / 64 * 64;
+    this->region_bytes = this->header_bytes + std::size_t(size) * size * this->mailbox_bytes;
+    void *address = ::mmap(nullptr, this->region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Could not map the shared memory: " + std::string(std::strerror(errno)));
+    this->region = static_cast<char*>(address);
+
+    // the atomics are lock-free, so they work across the processes sharing the mapping
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free && sizeof(_control_s) <= 64);
+    new (this->region) _control_s{};
+    this->pids()[0] = ::getpid(); // the caller is worker 0 - the children compare it with their parent
+}
+
+SharedMemoryTransport::~SharedMemoryTransport () {
+    ::munmap(this->region, this->region_bytes);
+}
+
+SharedMemoryTransport::_control_s* SharedMemoryTransport::control () {
+    return reinterpret_cast<_control_s*>(this->region);
+}
+
+pid_t* SharedMemoryTransport::pids () {
+    return reinterpret_cast<pid_t*>(this->region + 64);
+}
+
+SharedMemoryTransport::_mailbox_s* SharedMemoryTransport::mailbox (int from, int to) {
+    return reinterpret_cast<_mailbox_s*>(this->region + this->header_bytes + (std::size_t(from) * this->n_workers + to) * this->mailbox_bytes);
+}
+
+void SharedMemoryTransport::barrier () {
+    // the last worker to arrive starts the next generation, the others wait for it
+    _control_s *control = this->control();
+    std::uint32_t generation = control->generation.load(std::memory_order_acquire);
+    if (control->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == std::uint32_t(this->n_workers)) {
+        control->arrived.store(0, std::memory_order_relaxed);
+        control->generation.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    for (int spins = 0; control->generation.load(std::memory_order_acquire) == generation; spins++) {
+        if (control->failed.load(std::memory_order_acquire))
+            throw std::runtime_error("Another worker failed during an all-to-all");
+        if (spins % 256 == 255)
+            this->check_workers();
+        sched_yield();
+    }
+}
+
+void SharedMemoryTransport::check_workers () {
+    // a child which exited successfully has passed the last barrier - only the other exits are failures
+    // WNOWAIT leaves the children to be reaped by the caller
+    int failed = -1;
+    if (this->worker_rank == 0) {
+        for (int w = 1; w < this->n_workers && failed < 0; w++) {
+            siginfo_t info = {};
+            pid_t pid = this->pids()[w];
+            if (pid > 0 && ::waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == pid
+                && (info.si_code != CLD_EXITED || info.si_status != 0))
+                failed = w;
+        }
+    }
+    else if (::getppid() != this->pids()[0])
+        failed = 0;
+
+    if (failed >= 0) {
+        this->control()->failed.store(1, std::memory_order_release);
+        throw std::runtime_error("Worker " + std::to_string(failed) + " died during an all-to-all");
+    }
+}
+
+void SharedMemoryTransport::spawned (int rank, pid_t pid) {
+    // recorded by the parent - a child killed before it runs any code is detected as well
+    this->pids()[rank] = pid;
+}
+
+void SharedMemoryTransport::attach (int rank) {
+    this->worker_rank = rank;
+}
+
+int SharedMemoryTransport::rank () const {
+    return this->worker_rank;
+}
+
+int SharedMemoryTransport::size () const {
+    return this->n_workers;
+}
+
+void SharedMemoryTransport::all_to_all (_batches &send, _batches &receive) {
+    int me = this->worker_rank;
+    receive.resize(this->n_workers);
+    receive[me] = std::move(send[me]);
+    send[me].clear();
+    for (int w = 0; w < this->n_workers; w++)
+        if (w != me)
+            receive[w].clear();
+
+    std::vector <std::size_t> sent(this->n_workers, 0);
+    while (true) {
+        for (int w = 0; w < this->n_workers; w++) {
+            if (w == me)
+                continue;
+            _mailbox_s *box = this->mailbox(me, w);
+            std::size_t count = std::min(this->capacity, send[w].size() - sent[w]);
+            std::memcpy(box + 1, send[w].data() + sent[w], 8 * count);
+            box->count = count;
+            sent[w] += count;
+            box->more = sent[w] < send[w].size();
+        }
+        this->barrier();
+
+        // the flags of all the mailboxes are stable until the second barrier - every worker decides alike
+        bool more = false;
+        for (int from = 0; from < this->n_workers; from++)
+            for (int to = 0; to < this->n_workers; to++)
+                if (from != to)
+                    more = more || this->mailbox(from, to)->more;
+        for (int w = 0; w < this->n_workers; w++) {
+            if (w == me)
+                continue;
+            const _mailbox_s *box = this->mailbox(w, me);
+            const std::uint64_t *words = reinterpret_cast<const std::uint64_t*>(box + 1);
+            receive[w].insert(receive[w].end(), words, words + box->count);
+        }
+        this->barrier();
+
+        if (!more)
+            return;
+    }
+}
+
+
+// distributed bfs
+std::vector <std::uint64_t> algorithm::_dbfs_candidate (IntGraphView graph, algorithm::_dbfs_s &ds) {
+    while (ds.active < ds.last && (ds.parent_rank[ds.active - ds.first] != ds.unvisited || graph.out_deg(ds.active) == 0)) {
+        ds.isolated += ds.parent_rank[ds.active - ds.first] == ds.unvisited;
+        ds.active++;
+    }
+    return {std::uint64_t(ds.active < ds.last ? ds.active : ds.num_vertices), ds.isolated};
+}
+
+int algorithm::_dbfs_next_root (algorithm::_dbfs_s &ds, const _batches &receive, int me, std::size_t &size) {
+    int root = ds.num_vertices;
+    for (const std::vector <std::uint64_t> &batch : receive)
+        root = std::min<int>(root, batch[0]);
+
+    // the roots below `root` are the unvisited vertices of the workers up to its owner
+    int last_worker = root < ds.num_vertices ? root / ds.block : receive.size() - 1;
+    std::size_t position = size;
+    for (int w = 0; w < std::min(me, last_worker + 1); w++)
+        position += receive[w][1];
+    if (me <= last_worker && ds.isolated > 0) {
+        for (; ds.cursor < std::min(root, ds.last); ds.cursor++)
+            if (ds.parent_rank[ds.cursor - ds.first] == ds.unvisited) {
+                ds.parent_rank[ds.cursor - ds.first] = 0;
+                ds.position[ds.cursor - ds.first] = position++;
+            }
+        ds.levels[0].frontier += ds.isolated;
+        ds.isolated = 0;
+    }
+
+    for (int w = 0; w <= std::min<int>(last_worker, receive.size() - 1); w++)
+        size += receive[w][1];
+    return root;
+}
+
+template <typename Transport>
+void algorithm::_dbfs_exchange (Transport &transport, algorithm::_dbfs_s &ds, _batches &send, _batches &receive, std::size_t depth) {
+    if (ds.levels.size() <= depth)
+        ds.levels.resize(depth + 1);
+    for (int w = 0; w < transport.size(); w++)
+        if (w != transport.rank())
+            ds.levels[depth].bytes += 8 * send[w].size();
+
+    GRAPH_PHASE("exchange");
+    transport.all_to_all(send, receive);
+    ds.rounds++;
+}
+
+template <typename Transport>
+void algorithm::_dbfs_worker (IntGraphView graph, Transport &transport, algorithm::_dbfs_s &ds) {
+    int me = transport.rank();
+    int num_workers = transport.size();
+    _batches send(num_workers), receive(num_workers);
+    auto owner = [&](int v) { return v / ds.block; };
+
+    // the first root
+    for (int w = 0; w < num_workers; w++)
+        send[w] = algorithm::_dbfs_candidate(graph, ds);
+    algorithm::_dbfs_exchange(transport, ds, send, receive, 0);
+    std::size_t size = 0; // vertices in the search order
+    int root = algorithm::_dbfs_next_root(ds, receive, me, size);
+
+    std::vector <int> discovered;
+    while (root < ds.num_vertices) {
+        if (owner(root) == me) {
+            ds.parent_rank[root - ds.first] = 0;
+            ds.position[root - ds.first] = size;
+            ds.frontier = {root};
+        }
+        size++;
+
+        for (std::size_t depth = 0; ; depth++) {
+            GRAPH_PHASE("level");
+            // expansion: (parent << 32 | vertex, rank) candidates to the owners of the vertices
+            for (std::vector <std::uint64_t> &batch : send)
+                batch.clear();
+            for (int u : ds.frontier) {
+                std::span <const int> adjacent = graph[u];
+                std::uint64_t u_rank = std::uint64_t(ds.position[u - ds.first]) << 32;
+                GRAPH_COUNT(edges_scanned, adjacent.size());
+                for (std::size_t pos = 0; pos < adjacent.size(); pos++) {
+                    int v = adjacent[pos];
+                    // own vertices of the previous levels are filtered before the exchange
+                    if (owner(v) == me && ds.parent_rank[v - ds.first] != ds.unvisited)
+                        continue;
+                    send[owner(v)].push_back((std::uint64_t(u) << 32) | std::uint32_t(v));
+                    send[owner(v)].push_back(u_rank | pos);
+                }
+            }
+            if (ds.levels.size() <= depth)
+                ds.levels.resize(depth + 1);
+            ds.levels[depth].frontier += ds.frontier.size();
+            for (int w = 0; w < num_workers; w++)
+                if (w != me)
+                    ds.levels[depth].messages += send[w].size() / 2;
+            algorithm::_dbfs_exchange(transport, ds, send, receive, depth);
+
+            // vertices of the previous levels always have a lower rank
+            discovered.clear();
+            for (const std::vector <std::uint64_t> &batch : receive)
+                for (std::size_t i = 0; i < batch.size(); i += 2) {
+                    int v = std::uint32_t(batch[i]);
+                    std::uint64_t &rank = ds.parent_rank[v - ds.first];
+                    if (batch[i + 1] >= rank)
+                        continue;
+                    if (rank == ds.unvisited) {
+                        discovered.push_back(v);
+                        ds.isolated -= v < ds.active;
+                    }
+                    rank = batch[i + 1];
+                    ds.parent_idx[v - ds.first] = batch[i] >> 32;
+                }
+            std::sort(discovered.begin(), discovered.end(), [&](int a, int b) {
+                return ds.parent_rank[a - ds.first] < ds.parent_rank[b - ds.first];
+            });
+
+            // ranks: [next root candidate, unvisited vertices below it, sorted ranks of the new vertices] to every worker
+            std::vector <std::uint64_t> ranks = algorithm::_dbfs_candidate(graph, ds);
+            for (int v : discovered)
+                ranks.push_back(ds.parent_rank[v - ds.first]);
+            for (int w = 0; w < num_workers; w++)
+                send[w] = ranks;
+            algorithm::_dbfs_exchange(transport, ds, send, receive, depth);
+
+            // position of a new vertex: the new vertices of all the workers with a lower rank
+            std::vector <std::size_t> lower(num_workers, 2);
+            std::size_t level_size = 0;
+            for (const std::vector <std::uint64_t> &batch : receive)
+                level_size += batch.size() - 2;
+            for (std::size_t i = 0; i < discovered.size(); i++) {
+                std::uint64_t rank = ds.parent_rank[discovered[i] - ds.first];
+                std::size_t position = size + i;
+                for (int w = 0; w < num_workers; w++) {
+                    if (w == me)
+                        continue;
+                    while (lower[w] < receive[w].size() && receive[w][lower[w]] < rank)
+                        lower[w]++;
+                    position += lower[w] - 2;
+                }
+                ds.position[discovered[i] - ds.first] = position;
+            }
+
+            ds.frontier.swap(discovered);
+            size += level_size;
+            if (level_size == 0) {
+                root = algorithm::_dbfs_next_root(ds, receive, me, size);
+                break;
+            }
+        }
+    }
+}
+
+template <typename Transport>
+DistributedResult algorithm::_dbfs_reduce (Transport &transport, algorithm::_dbfs_s &ds) {
+    int num_workers = transport.size();
+    _batches send(num_workers), receive(num_workers);
+    std::vector <std::uint64_t> &batch = send[0];
+    batch.push_back(ds.levels.size());
+    for (const LevelTraffic &level : ds.levels)
+        batch.insert(batch.end(), {level.frontier, level.messages, level.bytes});
+    for (int v = ds.first; v < ds.last; v++)
+        batch.push_back((std::uint64_t(ds.position[v - ds.first]) << 32) | std::uint32_t(ds.parent_idx[v - ds.first]));
+    transport.all_to_all(send, receive);
+    ds.rounds++;
+
+    DistributedResult result;
+    if (transport.rank() != 0)
+        return result;
+
+    result.rounds = ds.rounds;
+    result.search.order.resize(ds.num_vertices);
+    result.search.parent_idx.resize(ds.num_vertices);
+    for (int w = 0; w < num_workers; w++) {
+        const std::vector <std::uint64_t> &words = receive[w];
+        std::size_t num_levels = words[0];
+        if (result.levels.size() < num_levels)
+            result.levels.resize(num_levels);
+        for (std::size_t level = 0; level < num_levels; level++) {
+            result.levels[level].frontier += words[1 + 3 * level];
+            result.levels[level].messages += words[2 + 3 * level];
+            result.levels[level].bytes += words[3 + 3 * level];
+        }
+
+        int first = std::min(ds.num_vertices, w * ds.block);
+        for (std::size_t i = 1 + 3 * num_levels; i < words.size(); i++) {
+            int v = first + (i - 1 - 3 * num_levels);
+            result.search.order[words[i] >> 32] = v;
+            result.search.parent_idx[v] = int(std::uint32_t(words[i]));
+        }
+    }
+    return result;
+}
+
+template <typename Transport>
+DistributedResult algorithm::distributed_bfs (IntGraphView graph, int num_workers) {
+    if (num_workers < 1)
+        throw std::invalid_argument("Error: The number of workers must be positive");
+
+    Transport transport(num_workers);
+    int num_vertices = graph.num_vertices();
+    auto worker_state = [&](int rank) {
+        algorithm::_dbfs_s ds;
+        ds.num_vertices = num_vertices;
+        ds.block = std::max(1, (num_vertices + num_workers - 1) / num_workers);
+        ds.first = std::min(num_vertices, rank * ds.block);
+        ds.last = std::min(num_vertices, ds.first + ds.block);
+        ds.parent_rank.assign(ds.last - ds.first, ds.unvisited);
+        ds.parent_idx.assign(ds.last - ds.first, -1);
+        ds.position.assign(ds.last - ds.first, -1);
+        ds.cursor = ds.first;
+        ds.active = ds.first;
+        ds.isolated = 0;
+        ds.levels.resize(1);
+        return ds;
+    };
+
+    // the workers 1 .. n - 1 are child processes - the caller is worker 0
+    std::vector <pid_t> children;
+    auto stop_children = [&] {
+        for (pid_t child : children)
+            ::kill(child, SIGKILL);
+        for (pid_t child : children)
+            ::waitpid(child, nullptr, 0);
+    };
+
+    std::cout.flush();
+    std::fflush(nullptr);
+    for (int rank = 1; rank < num_workers; rank++) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            stop_children();
+            throw std::runtime_error("Could not start a worker: " + std::string(std::strerror(errno)));
+        }
+        if (pid == 0) {
+            int status = 0;
+            try {
+                transport.attach(rank);
+                algorithm::_dbfs_s ds = worker_state(rank);
+                algorithm::_dbfs_worker(graph, transport, ds);
+                algorithm::_dbfs_reduce(transport, ds);
+            }
+            catch (std::exception &e) {
+                std::cerr << "Worker " << rank << ": " << e.what() << "\n";
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        children.push_back(pid);
+        transport.spawned(rank, pid);
+    }
+
+    DistributedResult result;
+    try {
+        transport.attach(0);
+        algorithm::_dbfs_s ds = worker_state(0);
+        algorithm::_dbfs_worker(graph, transport, ds);
+        result = algorithm::_dbfs_reduce(transport, ds);
+    }
+    catch (...) {
+        stop_children();
+        throw;
+    }
+
+    bool failed = false;
+    for (pid_t child : children) {
+        int status;
+        failed = ::waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || failed;
+    }
+    if (failed)
+        throw std::runtime_error("A worker of the distributed bfs failed");
+    return result;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include "graph.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    class DynamicTopologicalOrder {
+        // Topological order of a DAG maintained under edge insertions (Pearce-Kelly)
+        // An inserted edge (u, v) with u already before v costs O(1); otherwise only the vertices
+        // between v and u in the order which are reachable from v / reach u are searched and reordered
+        // Edges which would create a cycle are rejected and leave the order unchanged
+        // The base graph is not copied - it must be frozen with in-edges and outlive the order
+        private:
+            IntGraphView graph;
+            std::vector <std::vector <int>> added_out; // edges inserted after the construction
+            std::vector <std::vector <int>> added_in;
+            std::vector <int> position_of; // vertex -> its position in the order
+            std::vector <int> order; // position -> vertex
+            std::size_t num_added_edges = 0;
+
+            // search workspace
+            std::vector <bool> visited;
+            std::vector <int> stack;
+            std::vector <int> delta_forward; // reachable from v, before u
+            std::vector <int> delta_backward; // reaching u, after v
+
+            bool search_forward (int vertex, int upper_bound);
+            void search_backward (int vertex, int lower_bound);
+            void reorder();
+
+        public:
+            DynamicTopologicalOrder (IntGraphView graph);
+            ~DynamicTopologicalOrder() = default;
+
+            int num_vertices() const;
+            std::size_t num_edges() const; // base and inserted edges
+            std::span <const int> topological_order() const;
+            int position (int vertex) const;
+            bool precedes (int u, int v) const;
+
+            // returns false (and does not insert the edge) if it would create a cycle
+            // or if any of the vertices does not exist
+            bool add_edge (int u, int v);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+DynamicTopologicalOrder::DynamicTopologicalOrder (IntGraphView graph) {
+    if (!graph.has_in_edges())
+        throw std::invalid_argument("Graph was frozen without in-edges!");
+
+    this->graph = graph;
+    this->order = algorithm::topological_sort(graph);
+
+    int num_vertices = graph.num_vertices();
+    this->position_of.resize(num_vertices);
+    for (int i = 0; i < num_vertices; i++)
+        this->position_of[this->order[i]] = i;
+
+    this->added_out.resize(num_vertices);
+    this->added_in.resize(num_vertices);
+    this->visited.assign(num_vertices, false);
+}
+
+int DynamicTopologicalOrder::num_vertices () const {
+    return this->order.size();
+}
+
+std::size_t DynamicTopologicalOrder::num_edges () const {
+    return this->graph.num_edges() + this->num_added_edges;
+}
+
+std::span <const int> DynamicTopologicalOrder::topological_order () const {
+    return this->order;
+}
+
+int DynamicTopologicalOrder::position (int vertex) const {
+    return this->position_of[vertex];
+}
+
+bool DynamicTopologicalOrder::precedes (int u, int v) const {
+    return this->position_of[u] < this->position_of[v];
+}
+
+bool DynamicTopologicalOrder::add_edge (int u, int v) {
+    if (u < 0 || u >= this->num_vertices())
+        return false;
+
+    if (v < 0 || v >= this->num_vertices())
+        return false;
+
+    int lower_bound = this->position_of[v];
+    int upper_bound = this->position_of[u];
+    if (lower_bound < upper_bound) {
+        // the affected region: positions [lower_bound, upper_bound]
+        if (!this->search_forward(v, upper_bound))
+            return false;
+        this->search_backward(u, lower_bound);
+        this->reorder();
+    }
+    else if (lower_bound == upper_bound) // self-loop
+        return false;
+
+    this->added_out[u].push_back(v);
+    this->added_in[v].push_back(u);
+    this->num_added_edges++;
+    return true;
+}
+
+bool DynamicTopologicalOrder::search_forward (int vertex, int upper_bound) {
+    // visits the vertices reachable from `vertex` placed before `upper_bound`
+    // returns false if the vertex at `upper_bound` is reachable (cycle)
+    this->stack.assign(1, vertex);
+    this->visited[vertex] = true;
+    this->delta_forward.assign(1, vertex);
+
+    while (!this->stack.empty()) {
+        int v = this->stack.back();
+        this->stack.pop_back();
+
+        for (std::span <const int> adjacent : {this->graph[v], std::span<const int>(this->added_out[v])})
+            for (int adj : adjacent) {
+                if (this->position_of[adj] == upper_bound) {
+                    for (int w : this->delta_forward)
+                        this->visited[w] = false;
+                    this->delta_forward.clear();
+                    return false;
+                }
+
+                if (!this->visited[adj] && this->position_of[adj] < upper_bound) {
+                    this->visited[adj] = true;
+                    this->delta_forward.push_back(adj);
+                    this->stack.push_back(adj);
+                }
+            }
+    }
+
+    return true;
+}
+
+void DynamicTopologicalOrder::search_backward (int vertex, int lower_bound) {
+    // visits the vertices which reach `vertex` placed after `lower_bound`
+    this->stack.assign(1, vertex);
+    this->visited[vertex] = true;
+    this->delta_backward.assign(1, vertex);
+
+    while (!this->stack.empty()) {
+        int v = this->stack.back();
+        this->stack.pop_back();
+
+        for (std::span <const int> adjacent : {this->graph.adjacent_in(v), std::span<const int>(this->added_in[v])})
+            for (int adj : adjacent)
+                if (!this->visited[adj] && this->position_of[adj] > lower_bound) {
+                    this->visited[adj] = true;
+                    this->delta_backward.push_back(adj);
+                    this->stack.push_back(adj);
+                }
+    }
+}
+
+void DynamicTopologicalOrder::reorder () {
+    // the backward vertices take the lowest of the freed positions, then the forward ones -
+    // both keeping their relative order
+    auto by_position = [this](int u, int v) { return this->position_of[u] < this->position_of[v]; };
+    std::sort(this->delta_backward.begin(), this->delta_backward.end(), by_position);
+    std::sort(this->delta_forward.begin(), this->delta_forward.end(), by_position);
+
+    std::vector <int> positions;
+    positions.reserve(this->delta_backward.size() + this->delta_forward.size());
+    for (int v : this->delta_backward)
+        positions.push_back(this->position_of[v]);
+    for (int v : this->delta_forward)
+        positions.push_back(this->position_of[v]);
+    std::inplace_merge(positions.begin(), positions.begin() + this->delta_backward.size(), positions.end());
+
+    std::size_t i = 0;
+    for (std::vector <int> *delta : {&this->delta_backward, &this->delta_forward})
+        for (int v : *delta) {
+            this->visited[v] = false;
+            this->position_of[v] = positions[i];
+            this->order[positions[i++]] = v;
+        }
+}
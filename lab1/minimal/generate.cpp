@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "generators.hpp"
+
+
+
+
+
+// usage: ./generate <model:scale[:edge factor[:D|U[:seed]]]> <output file> [num threads]
+// model: rmat (Graph500 Kronecker), er (Erdos-Renyi G(n, m)), grid (2D grid), dag (random DAG)
+// The graph is written in the D/U text format read by ./main and ./benchmark - the same seed
+// gives the same file for any number of threads
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Error: Invalid arguments\n");
+        return 1;
+    }
+
+    std::string spec = argv[1];
+    std::string file_name = argv[2];
+    try {
+        graph::GeneratorOptions options = graph::generator_from_string(spec);
+        options.num_threads = argc > 3 ? std::stoi(argv[3]) : 0;
+        graph::GraphGenerator generator(options);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        generator.write(file_name);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+
+        std::cout << "Vertices: " << generator.num_vertices() << ", edges: " << generator.num_edges() << "\n";
+        std::cout << "Graph saved: " << file_name << "\n";
+        std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+    }
+    catch (std::exception& e) {
+        std::cout << "Error: Could not generate '" << spec << "'!\n\t";
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <span>
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "graph.hpp"
+#include "parallel.hpp"
+#include "instrument.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    enum class GraphModel {
+        rmat, // recursive matrix / Graph500 Kronecker - skewed degrees, small world
+        erdos_renyi, // G(n, m) - uniform endpoints
+        grid, // 2D grid - edges to the right and down neighbours, large diameter
+        dag // random DAG - edges from the lower to the higher rank of a hidden topological order
+    };
+
+    GraphModel model_from_string (std::string name);
+
+    struct GeneratorOptions {
+        GraphModel model = GraphModel::rmat;
+        int scale = 16; // 2^scale vertices (the grid: 2^(scale / 2) rows)
+        int edge_factor = 16; // edges per vertex - not used by the grid
+        bool directed = true;
+        std::uint64_t seed = 1;
+        double a = 0.57, b = 0.19, c = 0.19; // R-MAT quadrant probabilities (Graph500) - d = 1 - a - b - c
+        bool permute = true; // the vertex ids are scrambled by a seeded bijection (no hubs / order at the low ids)
+        int num_threads = 0;
+    };
+
+    // "model:scale[:edge factor[:D|U[:seed]]]", e.g. "rmat:20", "grid:16:0:U" - model: rmat, er, grid, dag
+    GeneratorOptions generator_from_string (std::string spec);
+    bool is_generator_spec (std::string input); // the part before the first ':' is a model name
+
+    std::uint64_t _splitmix64 (std::uint64_t &state); // advances the state and returns its next value
+
+
+
+    class GraphGenerator {
+        // Seeded generator of synthetic graphs
+        // Edge i is a function of (seed, i) only - a counter-based splitmix64 stream - so the graph
+        // does not depend on the number of threads and any block of edges can be generated on its own
+        // The edges may contain loops and duplicates (except the grid) - `graph` can drop them
+        private:
+            GeneratorOptions options;
+            int n_vertices;
+            std::size_t n_edges;
+            int columns; // grid
+            std::uint64_t edge_key; // the stream of edge i starts at edge_key ^ (i * odd constant)
+            std::uint32_t threshold_a, threshold_ab, threshold_abc; // R-MAT quadrants of a 32-bit draw
+            std::uint64_t scramble_mask;
+            std::uint64_t scramble_keys[4];
+            int scramble_shift;
+
+            int _scramble (std::uint64_t vertex) const;
+
+        public:
+            GraphGenerator (GeneratorOptions options);
+
+            bool is_directed() const;
+            int num_vertices() const;
+            std::size_t num_edges() const;
+            std::pair <int, int> edge (std::size_t index) const; // vertices 0 .. n - 1
+            // edges [first, first + out.size())
+            void edges (std::size_t first, std::span <std::pair <int, int>> out) const;
+
+            std::vector <std::pair <int, int>> edge_list() const;
+            IntGraph graph (BuildOptions build = BuildOptions()) const;
+            // the D/U text format read by `IntGraph::from_file` - generated and written block by block,
+            // so the edge list is never stored
+            void write (std::string file_name) const;
+    };
+}
+
+// Definitions
+using namespace graph;
+
+GraphModel graph::model_from_string (std::string name) {
+    if (name == "rmat")
+        return GraphModel::rmat;
+    if (name == "er")
+        return GraphModel::erdos_renyi;
+    if (name == "grid")
+        return GraphModel::grid;
+    if (name == "dag")
+        return GraphModel::dag;
+    throw std::invalid_argument("Invalid graph model (" + name + ") - must be ['rmat', 'er', 'grid', 'dag']");
+}
+
+GeneratorOptions graph::generator_from_string (std::string spec) {
+    std::vector <std::string> fields;
+    std::size_t begin = 0;
+    while (true) {
+        std::size_t end = spec.find(':', begin);
+        fields.push_back(spec.substr(begin, end - begin));
+        if (end == std::string::npos)
+            break;
+        begin = end + 1;
+    }
+    if (fields.size() < 2 || fields.size() > 5)
+        throw std::invalid_argument("Invalid generator (" + spec + ") - must be 'model:scale[:edge factor[:D|U[:seed]]]'");
+
+    GeneratorOptions options;
+    options.model = graph::model_from_string(fields[0]);
+    options.scale = std::stoi(fields[1]);
+    if (fields.size() > 2)
+        options.edge_factor = std::stoi(fields[2]);
+    if (fields.size() > 3) {
+        if (fields[3] != "D" && fields[3] != "U")
+            throw std::invalid_argument("Invalid Graph type (" + fields[3] + ") - must be 'U' or 'D'");
+        options.directed = fields[3] == "D";
+    }
+    if (fields.size() > 4)
+        options.seed = std::stoull(fields[4]);
+    return options;
+}
+
+bool graph::is_generator_spec (std::string input) {
+    std::string model = input.substr(0, input.find(':'));
+    return model.size() < input.size() && (model == "rmat" || model == "er" || model == "grid" || model == "dag");
+}
+
+std::uint64_t graph::_splitmix64 (std::uint64_t &state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+
+
+// GraphGenerator
+GraphGenerator::GraphGenerator (GeneratorOptions options) {
+    if (options.scale < 0 || options.scale > 30)
+        throw std::invalid_argument("Error: The scale must be in [0, 30]");
+    if (options.edge_factor < 0)
+        throw std::invalid_argument("Error: The edge factor must not be negative");
+    double d = 1 - options.a - options.b - options.c;
+    if (options.a < 0 || options.b < 0 || options.c < 0 || d < -1e-9)
+        throw std::invalid_argument("Error: The R-MAT probabilities must be non-negative and sum up to at most 1");
+
+    this->options = options;
+    this->n_vertices = 1 << options.scale;
+    this->columns = 1 << (options.scale - options.scale / 2);
+    int rows = this->n_vertices / this->columns;
+    if (options.model == GraphModel::grid)
+        this->n_edges = std::size_t(rows) * (this->columns - 1) + std::size_t(rows - 1) * this->columns;
+    else
+        this->n_edges = std::size_t(options.edge_factor) * this->n_vertices;
+    if (options.model == GraphModel::dag && this->n_vertices < 2)
+        this->n_edges = 0; // no edge without a loop
+
+    auto threshold = [](double p) {
+        return std::uint32_t(std::clamp(p, 0.0, 1.0) * 4294967295.0);
+    };
+    this->threshold_a = threshold(options.a);
+    this->threshold_ab = threshold(options.a + options.b);
+    this->threshold_abc = threshold(options.a + options.b + options.c);
+
+    // two rounds of (odd multiply + add, xorshift) - each step is a bijection of [0, 2^scale)
+    std::uint64_t state = options.seed;
+    this->edge_key = graph::_splitmix64(state);
+    for (std::uint64_t &key : this->scramble_keys)
+        key = graph::_splitmix64(state);
+    this->scramble_keys[0] |= 1;
+    this->scramble_keys[2] |= 1;
+    this->scramble_mask = this->n_vertices - 1;
+    this->scramble_shift = std::max(1, (options.scale + 1) / 2);
+}
+
+int GraphGenerator::_scramble (std::uint64_t vertex) const {
+    if (!this->options.permute)
+        return vertex;
+
+    for (int round = 0; round < 2; round++) {
+        vertex = (vertex * this->scramble_keys[2 * round] + this->scramble_keys[2 * round + 1]) & this->scramble_mask;
+        vertex ^= vertex >> this->scramble_shift;
+    }
+    return vertex;
+}
+
+bool GraphGenerator::is_directed () const {
+    return this->options.directed;
+}
+
+int GraphGenerator::num_vertices () const {
+    return this->n_vertices;
+}
+
+std::size_t GraphGenerator::num_edges () const {
+    return this->n_edges;
+}
+
+std::pair <int, int> GraphGenerator::edge (std::size_t index) const {
+    std::uint64_t state = this->edge_key ^ (index * 0xd1b54a32d192ed03);
+    std::uint64_t u = 0, v = 0;
+    switch (this->options.model) {
+        case GraphModel::rmat: {
+            // one quadrant of the adjacency matrix per level - 32 bits of a draw each
+            std::uint64_t bits = 0;
+            for (int level = 0; level < this->options.scale; level++) {
+                if (level % 2 == 0)
+                    bits = graph::_splitmix64(state);
+                std::uint32_t r = level % 2 == 0 ? bits : bits >> 32;
+                u <<= 1;
+                v <<= 1;
+                if (r >= this->threshold_abc)
+                    u |= 1, v |= 1;
+                else if (r >= this->threshold_ab)
+                    u |= 1;
+                else if (r >= this->threshold_a)
+                    v |= 1;
+            }
+            break;
+        }
+        case GraphModel::erdos_renyi: {
+            std::uint64_t bits = graph::_splitmix64(state);
+            u = (bits & 0xffffffff) * this->n_vertices >> 32;
+            v = (bits >> 32) * this->n_vertices >> 32;
+            break;
+        }
+        case GraphModel::grid: {
+            // the edges to the right neighbours row by row, then the edges to the down neighbours
+            std::size_t horizontal = std::size_t(this->n_vertices / this->columns) * (this->columns - 1);
+            if (index < horizontal) {
+                u = index / (this->columns - 1) * this->columns + index % (this->columns - 1);
+                v = u + 1;
+            }
+            else {
+                u = index - horizontal;
+                v = u + this->columns;
+            }
+            break;
+        }
+        case GraphModel::dag: {
+            // distinct ranks, the lower one first
+            std::uint64_t bits = graph::_splitmix64(state);
+            u = (bits & 0xffffffff) * this->n_vertices >> 32;
+            v = (bits >> 32) * (this->n_vertices - 1) >> 32;
+            v += v >= u;
+            if (u > v)
+                std::swap(u, v);
+            break;
+        }
+    }
+    return std::make_pair(this->_scramble(u), this->_scramble(v));
+}
+
+void GraphGenerator::edges (std::size_t first, std::span <std::pair <int, int>> out) const {
+    for (std::size_t i = 0; i < out.size(); i++)
+        out[i] = this->edge(first + i);
+}
+
+std::vector <std::pair <int, int>> GraphGenerator::edge_list () const {
+    GRAPH_PHASE("generate");
+    std::vector <std::pair <int, int>> edges(this->n_edges);
+    parallel::Team team(this->options.num_threads);
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(edges.size(), thread_id, team.size());
+        this->edges(first, std::span(edges).subspan(first, last - first));
+    });
+    return edges;
+}
+
+IntGraph GraphGenerator::graph (BuildOptions build) const {
+    // the edge array and the CSR coexist during the build
+    if (build.num_threads == 0)
+        build.num_threads = this->options.num_threads;
+
+    IntGraph graph;
+    graph.from_edges(this->options.directed, this->n_vertices, this->edge_list(), build);
+    return graph;
+}
+
+void GraphGenerator::write (std::string file_name) const {
+    if (this->n_edges > INT_MAX)
+        throw std::invalid_argument("Error: The text format stores at most " + std::to_string(INT_MAX) + " edges");
+
+    std::ofstream out(file_name, std::ios::binary);
+    if (!out)
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    GRAPH_PHASE("generate");
+    out << (this->options.directed ? 'D' : 'U') << "\n" << this->n_vertices << "\n" << this->n_edges << "\n";
+
+    // rounds of one block per thread: the threads format their blocks, which are then written in order
+    constexpr std::size_t block_size = 1 << 16;
+    parallel::Team team(this->options.num_threads);
+    std::vector <std::string> buffers(team.size());
+    for (std::size_t round_first = 0; round_first < this->n_edges; round_first += block_size * team.size()) {
+        team.run([&](int thread_id) {
+            std::size_t first = std::min(this->n_edges, round_first + thread_id * block_size);
+            std::size_t last = std::min(this->n_edges, first + block_size);
+            std::string &buffer = buffers[thread_id];
+            buffer.resize((last - first) * 24); // 2 x (10 digits + separator)
+            char *it = buffer.data();
+            char *end = it + buffer.size();
+            for (std::size_t i = first; i < last; i++) {
+                auto [u, v] = this->edge(i);
+                it = std::to_chars(it, end, u + 1).ptr;
+                *it++ = ' ';
+                it = std::to_chars(it, end, v + 1).ptr;
+                *it++ = '\n';
+            }
+            buffer.resize(it - buffer.data());
+        });
+        for (const std::string &buffer : buffers)
+            out.write(buffer.data(), buffer.size());
+    }
+
+    if (!out)
+        throw std::invalid_argument("Could not write: " + file_name + "!");
+}
@@ -4,13 +4,19 @@
 #include <fstream>
 #include <vector>
 #include <numeric>
-#include <deque>
-#include <queue>
 #include <stack>
 #include <algorithm>
 #include <cmath>
-#include <functional>
+#include <bit>
 #include <stdexcept>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <climits>
+#include "parallel.hpp"
+#include "mapped_file.hpp"
+#include "instrument.hpp"
 
 
 
@@ -18,28 +24,174 @@
 
 // Declarations 
 namespace graph {
+    class IntGraph;
+    class GraphSnapshot;
+
+    class IntGraphView {
+        // Non-owning, read-only view of the (frozen) CSR arrays of an IntGraph
+        // Cheap to copy - the algorithms take it by value
+        private:
+            bool directed = false;
+            int n_vertices = 0;
+            std::span <const std::size_t> out_offsets;
+            std::span <const int> out_targets;
+            std::span <const std::size_t> in_offsets;
+            std::span <const int> in_sources;
+            std::span <const int> in_positions;
+
+            friend class GraphSnapshot;
+
+        public:
+            IntGraphView() = default;
+            IntGraphView (const IntGraph &graph);
+            // view of CSR arrays stored elsewhere (e.g. a memory mapped snapshot)
+            IntGraphView (
+                bool directed, int n_vertices,
+                std::span <const std::size_t> out_offsets, std::span <const int> out_targets,
+                std::span <const std::size_t> in_offsets,
+                std::span <const int> in_sources = {}, std::span <const int> in_positions = {}
+            );
+            ~IntGraphView() = default;
+
+            void show() const;
+            bool is_directed() const;
+            bool is_empty() const;
+            bool has_in_edges() const;
+            bool has_reverse_csr() const;
+            int num_vertices() const;
+            std::size_t num_edges() const;
+            std::span <const int> operator [] (int index) const;
+            std::span <const int> adjacent_in (int index) const;
+            // position of each `adjacent_in(index)` edge in its source's adjacency list
+            std::span <const int> adjacent_in_positions (int index) const;
+            int in_deg (int vertex) const;
+            int out_deg (int vertex) const;
+    };
+
+
+
+    struct BuildOptions {
+        // `IntGraph::from_edges` options
+        bool deduplicate = false; // a neighbour is stored once in a list (an undirected loop as well)
+        bool remove_loops = false;
+        bool with_in_edges = false; // the reverse CSR
+        int num_threads = 0;
+    };
+
+
+
     class IntGraph {
+        // Adjacency is stored in the compressed sparse row (CSR) form:
+        // the neighbours of `v` are out_targets[out_offsets[v] .. out_offsets[v + 1]).
+        // Edges added with `add_edge` are buffered and become visible to the
+        // adjacency queries only after `freeze` is called.
+        // Until then the queries, the views and so the algorithms throw std::logic_error.
         private:
             bool directed;
-            std::vector <std::vector <int>> adjacency_list;
-            std::vector <int> in_deg_list;
+            int n_vertices = 0;
+            std::vector <std::size_t> out_offsets = {0};
+            std::vector <int> out_targets;
+            std::vector <std::size_t> in_offsets = {0};
+            // reverse CSR - built on request
+            std::vector <int> in_sources;
+            std::vector <int> in_positions; // in-edge -> its index in the source's adjacency list
+            std::vector <std::pair <int, int>> pending_edges;
+
+            friend class IntGraphView;
 
         public:
             IntGraph() = default;
             IntGraph (bool directed);
             ~IntGraph() = default;
 
-            void show();
-            bool is_directed();
-            bool is_empty();
-            int num_vertices();
-            std::vector <int> vertices();
-            std::vector<int>& operator [] (int index);
-            int in_deg (int vertex);
+            void show() const;
+            bool is_directed() const;
+            bool is_empty() const;
+            bool is_frozen() const;
+            bool has_in_edges() const;
+            bool has_reverse_csr() const;
+            int num_vertices() const;
+            std::size_t num_edges() const; // number of stored adjacency entries
+            std::vector <int> vertices() const;
+            std::span <const int> operator [] (int index) const;
+            std::span <const int> adjacent_in (int index) const;
+            int in_deg (int vertex) const;
+            int out_deg (int vertex) const;
             void push_vertices (int max_vertex);
             bool add_edge (int u, int v);
+            void freeze (bool with_in_edges = false);
+            // takes over already built CSR arrays (offsets of size n + 1, adjacency in the stored order)
+            void from_csr (bool directed, std::vector <std::size_t> out_offsets, std::vector <int> out_targets, bool with_in_edges = false);
+
+            // bulk construction from an edge array (vertices 0 .. n_vertices - 1) - the edges are radix sorted
+            // in parallel, so every neighbour list is in ascending order; undirected edges are stored both ways
+            void from_edges (bool directed, int n_vertices, std::span <const std::pair <int, int>> edges, BuildOptions options = BuildOptions());
+            // the file is memory mapped and its edge list is parsed and placed in the CSR arrays in parallel
+            void from_file (std::string file_name, bool with_in_edges = false, int num_threads = 0);
+    };
+
+    // reads the "[D|U] n m" header of a graph file (see `IntGraph::from_file`)
+    void read_header (std::istream &infile, bool &directed, int &n_vertices, int &n_edges);
+
+    // parsing of a memory mapped graph file
+    // `_` prefixed members should be considered private
+    struct _tokens_s {
+        // integers parsed by one thread from its byte range of the edge list
+        std::vector <int> values;
+        std::size_t begin = 0; // values taken over by the previous range to complete its last edge
+        bool malformed = false; // parsing stopped at a token which is not an int
+    };
+
+    bool _is_space (char c);
+    bool _scan_int (const char *&it, const char *end, int &value);
+    std::size_t _parse_header (std::span <const char> bytes, bool &directed, int &n_vertices, int &n_edges);
+    void _parse_tokens (std::span <const char> bytes, std::size_t first, std::size_t last, _tokens_s &tokens);
+
+
+
+    struct Components {
+        // flat vertex -> component index mapping
+        // grouped view (built by `group`): the vertices of the component c
+        // are vertices[offsets[c] .. offsets[c + 1]) in ascending order
+        int num_components = 0;
+        std::vector <int> component_idx;
+        std::vector <int> offsets;
+        std::vector <int> vertices;
+
+        void group();
+        bool is_grouped() const;
+        std::span <const int> operator [] (int component) const;
+    };
+
+
+
+    struct Schedule {
+        // topological order split into levels: the vertices of a level depend
+        // only on the vertices of the previous levels, so they can run in parallel
+        // level l: order[level_offsets[l] .. level_offsets[l + 1])
+        std::vector <int> order;
+        std::vector <int> level_offsets = {0};
+
+        int num_levels() const;
+        std::span <const int> operator [] (int level) const;
+    };
+
+
+
+    struct SearchResult {
+        // search order and the search tree as a parent array (-1: a root of the search)
+        // The tree is built as an IntGraph only on request - a search keeps O(|V|) words
+        // Optional (`search` with `with_times`): discovery and finish times on one clock
+        // counting both events - the [discovery, finish] intervals of a dfs are nested
+        std::vector <int> order;
+        std::vector <int> parent_idx;
+        std::vector <int> discovery = {}; // empty without times
+        std::vector <int> finish = {};
 
-            void from_file (std::string file_name);
+        int num_vertices() const;
+        int num_roots() const;
+        bool has_times() const;
+        IntGraph tree() const; // parent -> child edges, the children in ascending order
     };
 
 
@@ -47,89 +199,405 @@ namespace graph {
     namespace algorithm {
         // `_` prefixed members should be considered private
 
+        // traversal engine
+        // `traverse` pops vertices from the container until it is empty - the caller pushes the roots.
+        // The container policy and the visitor are template parameters, so every traversal
+        // is compiled into its own loop without indirect calls. Visitor hooks (all optional):
+        //   bool on_discover(v) - v was popped; false skips it (e.g. already visited)
+        //   bool on_edge(v, adj) - true pushes adj
+        //   void on_finish(v) - stack: all the vertices pushed while processing v were popped
+        //                       (dfs finish), queue: the edges of v were scanned
+        // Graph: any adjacency store with a range of neighbours in graph[v] (IntGraphView, CompressedGraph)
+        struct Stack {
+            // lifo container policy
+            static constexpr bool nested = true; // the finish of a vertex follows the finish of its pushed vertices
+            std::vector <int> items;
+
+            bool empty() const;
+            std::size_t size() const;
+            void push (int vertex);
+            int pop();
+        };
+
+        struct Queue {
+            // fifo container policy
+            static constexpr bool nested = false;
+            std::vector <int> items;
+            std::size_t head = 0;
+
+            bool empty() const;
+            std::size_t size() const;
+            void push (int vertex);
+            int pop();
+        };
+
+        template <typename Container, typename Visitor, typename Graph>
+        void traverse (const Graph &graph, Container &container, Visitor &visitor);
+
+
         // dfs, bfs
-        struct _container_f {
-            // stack and queue container operation functions
-            std::function <int(std::deque<int>&)> first;
-            std::function <void(std::deque<int>&)> pop_first;
+        template <bool WithTimes>
+        struct _search_s {
+            // search visitor - a vertex is visited when popped, so dfs follows the last pushed edge
+            std::vector <bool> visited;
+            SearchResult result;
+            int clock = 0;
+
+            bool on_discover (int v);
+            bool on_edge (int v, int adj);
+            void on_finish (int v) requires WithTimes;
+        };
+
+        template <typename Container, bool WithTimes, typename Graph>
+        SearchResult _search (const Graph &graph);
+
+        // the parent of a vertex is the vertex which reached it first
+        SearchResult search (IntGraphView graph, bool depth_first, bool with_times = false);
+
+
+        // direction-optimizing bfs (Beamer et al.)
+        // same search order and search tree as `search(graph, false)`
+        // the graph must be frozen with in-edges (reverse CSR)
+        // To reproduce the top-down parents a bottom-up step cannot stop at the first
+        // frontier in-neighbour, so it always costs all the unexplored in-edges -
+        // each level uses the direction that scans fewer edges
+        struct _bitmap {
+            std::vector <std::uint64_t> words;
+
+            _bitmap (int size = 0);
+            bool test (int index) const;
+            void set (int index);
+            void reset (int index);
+        };
+
+        struct _dobfs_s {
+            // structures required for the direction-optimizing bfs
+            _bitmap visited;
+            _bitmap frontier;
+            std::vector <int> parent_idx;
+            std::vector <int> order_idx; // position of a vertex in search_order
+            std::vector <std::pair <std::uint64_t, int>> discovered; // bottom-up only: (top-down rank, vertex)
+            std::vector <int> search_order;
+            std::size_t unexplored_edges; // in-edges of unvisited vertices
+        };
+
+        void _dobfs_visit (IntGraphView graph, _dobfs_s &bs, int v, int parent);
+        void _dobfs_top_down (IntGraphView graph, _dobfs_s &bs, std::size_t level_begin, std::size_t level_end);
+        void _dobfs_bottom_up (IntGraphView graph, _dobfs_s &bs, std::size_t level_begin, std::size_t level_end);
+
+        SearchResult direction_optimizing_bfs (IntGraphView graph);
+
+
+        // level-synchronous parallel bfs
+        // Vertices are claimed with a CAS on their parent rank (parent's position in the search order
+        // and the edge's position in the parent's adjacency list). The default mode keeps the first
+        // claim - any valid bfs tree; the deterministic mode keeps the minimal rank and sorts
+        // the levels - the same search order and search tree as `search(graph, false)`
+        struct _pbfs_s {
+            // structures required for the parallel bfs
+            static constexpr std::uint64_t unvisited = UINT64_MAX;
+            static constexpr std::size_t chunk_size = 64; // frontier vertices taken by a thread at once
+            static constexpr std::size_t sequential_limit = 1024; // smaller frontiers are not split
+
+            bool deterministic;
+            std::vector <std::uint64_t> parent_rank;
+            std::vector <int> parent_idx;
+            std::vector <int> search_order; // preallocated - `size` valid elements
+            std::size_t size;
+            std::vector <std::vector <std::pair <std::uint64_t, int>>> discovered; // thread-local next frontiers
+            std::vector <std::size_t> offsets; // of the thread-local frontiers in the next level
+            std::vector <std::pair <std::uint64_t, int>> next; // deterministic mode only
+            std::atomic <std::size_t> next_chunk;
         };
 
-        std::pair <std::vector <int>, IntGraph>  search (IntGraph graph, bool depth_first);
+        void _pbfs_expand (IntGraphView graph, _pbfs_s &ps, std::size_t level_end, int thread_id); // from ps.next_chunk
+        void _pbfs_emit (_pbfs_s &ps, const std::pair <std::uint64_t, int> &vertex, std::size_t index);
+        void _pbfs_level (IntGraphView graph, _pbfs_s &ps, parallel::Team &team, std::size_t level_begin, std::size_t level_end);
+
+        SearchResult parallel_bfs (IntGraphView graph, bool deterministic = false, int num_threads = 0);
 
 
         // finding IntGraph's topological order or acyclicity
-        std::vector <int> topological_sort (IntGraph graph);
+        struct _ts_s {
+            // Kahn's algorithm visitor - a vertex is pushed once all its in-edges were scanned
+            std::vector <int> in_deg;
+            std::vector <int> topological_order = {};
+
+            bool on_discover (int v);
+            bool on_edge (int v, int adj);
+        };
+
+        std::vector <int> topological_sort (IntGraphView graph);
+
+
+        // finding IntGraph's topological order by whole in-degree-zero wavefronts (parallel Kahn's algorithm)
+        // every level is sorted, so the schedule does not depend on the number of threads
+        struct _wts_s {
+            // structures required for the wavefront topological sort
+            static constexpr std::size_t chunk_size = 64; // level vertices taken by a thread at once
+            static constexpr std::size_t sequential_limit = 1024; // smaller levels are not split
+
+            std::vector <int> in_deg;
+            std::vector <int> order; // preallocated - `size` valid elements
+            std::size_t size;
+            std::vector <std::vector <int>> next; // thread-local next levels
+            std::atomic <std::size_t> next_chunk;
+        };
+
+        void _wts_gather (parallel::Team &team, _wts_s &ts);
+        void _wts_level (IntGraphView graph, parallel::Team &team, _wts_s &ts, std::size_t level_begin, std::size_t level_end);
+
+        Schedule wavefront_topological_sort (IntGraphView graph, int num_threads = 0);
 
 
         // finding IntGraph's strongly connected componnents
+        // Pearce's space-efficient variant of Tarjan's algorithm (iterative) - O(|V| + |E|)
+        // The components are indexed in the order of completion (reverse topological order)
+        template <typename Cursor>
         struct _scc_s {
             // structures required for the strong connecting algorithm
-            std::vector <int> componnent_index;
-            std::vector <int> low_link;
-            std::vector <bool> on_stack;
-            std::stack <int> stack;
+            std::vector <int> rindex; // 0: not visited, becomes num_vertices - component index
+            std::vector <bool> root;
+            std::vector <int> stack; // visited vertices not assigned to a componnent yet
+            std::vector <std::pair <int, Cursor>> dfs_stack; // (vertex, edge cursor - an iterator of graph[vertex])
+            int index;
             int componnent;
-            std::vector <std::vector<int>> scc;
         };
 
-        void _scc_unit (IntGraph &graph, _scc_s &cs, std::stack<int> &dfs_stack);
+        template <typename Graph, typename Cursor>
+        void _scc_visit (const Graph &graph, _scc_s <Cursor> &cs, int vertex);
+        template <typename Graph, typename Cursor>
+        void _scc_unit (const Graph &graph, _scc_s <Cursor> &cs, int vertex);
+        template <typename Graph>
+        Components _scc (const Graph &graph);
+
+        Components scc (IntGraphView graph);
+
+
+        // finding IntGraph's strongly connected componnents in parallel (Multistep, Slota et al.):
+        // trimming of trivial componnents, forward-backward search from a pivot - usually inside
+        // the giant componnent - and colouring for the remaining ones
+        // The componnents are the same as the ones of `scc`, but indexed in an arbitrary order
+        // The graph must be frozen with in-edges
+        struct _pscc_s {
+            // structures required for the parallel strong connecting algorithm
+            static constexpr int unassigned = -1;
+            static constexpr std::size_t chunk_size = 256; // frontier vertices taken by a thread at once
+
+            std::vector <int> component_idx;
+            std::vector <int> color; // colouring: the largest vertex which reaches a vertex
+            std::vector <int> mark; // epoch in which a vertex was reached last
+            int epoch;
+            std::atomic <int> num_components;
+            std::vector <int> frontier;
+            std::vector <std::vector <int>> next; // thread-local next frontiers
+            std::atomic <std::size_t> next_chunk;
+        };
+
+        // replaces the frontier with the concatenated thread-local next frontiers
+        void _pscc_gather (parallel::Team &team, _pscc_s &ps);
+
+        // expands the whole frontier - expand(v, next) - and gathers the next one
+        template <typename Expand>
+        void _pscc_step (parallel::Team &team, _pscc_s &ps, Expand expand);
+
+        void _pscc_trim (IntGraphView graph, parallel::Team &team, _pscc_s &ps);
+        void _pscc_forward_backward (IntGraphView graph, parallel::Team &team, _pscc_s &ps);
+        bool _pscc_coloring (IntGraphView graph, parallel::Team &team, _pscc_s &ps);
 
-        std::vector <std::vector <int>> scc (IntGraph graph);
+        Components parallel_scc (IntGraphView graph, int num_threads = 0);
 
 
         // checking if a IntGraph is bipartite
-        std::pair<std::vector <int>, std::vector <int>> bipartite_partition (IntGraph graph);
+        struct _bipartite_s {
+            // bfs coloring visitor
+            static constexpr int gray = 0; // not yet visited
+            static constexpr int red = 1; // blue: -1
+            std::vector <int> colors;
+
+            bool on_edge (int v, int adj);
+        };
+
+        template <typename Graph>
+        std::pair<std::vector <int>, std::vector <int>> _bipartite_partition (const Graph &graph);
+
+        std::pair<std::vector <int>, std::vector <int>> bipartite_partition (IntGraphView graph);
     };
 }
 
 // Definitions
 using namespace graph;
 
-// IntGraph container
-IntGraph::IntGraph (bool directed) {
+// IntGraph view
+IntGraphView::IntGraphView (const IntGraph &graph) {
+    // the CSR arrays do not contain the pending edges - a view of them would silently miss edges
+    if (!graph.is_frozen())
+        throw std::logic_error("Graph has edges added after the last freeze!");
+
+    this->directed = graph.directed;
+    this->n_vertices = graph.n_vertices;
+    this->out_offsets = graph.out_offsets;
+    this->out_targets = graph.out_targets;
+    this->in_offsets = graph.in_offsets;
+    this->in_sources = graph.in_sources;
+    this->in_positions = graph.in_positions;
+}
+
+IntGraphView::IntGraphView (
+    bool directed, int n_vertices,
+    std::span <const std::size_t> out_offsets, std::span <const int> out_targets,
+    std::span <const std::size_t> in_offsets,
+    std::span <const int> in_sources, std::span <const int> in_positions
+) {
     this->directed = directed;
+    this->n_vertices = n_vertices;
+    this->out_offsets = out_offsets;
+    this->out_targets = out_targets;
+    this->in_offsets = in_offsets;
+    this->in_sources = in_sources;
+    this->in_positions = in_positions;
 }
 
-void IntGraph::show() {
+void IntGraphView::show() const {
     int num_vertices = this->num_vertices();
     for (int v = 0; v < num_vertices; v++) {
         std::cout << v + 1 << ": ";
-        for (int adj : this->adjacency_list[v]) 
+        for (int adj : (*this)[v]) 
             std::cout << adj + 1 << " ";
         std::cout << "\n";
     }
 }
 
-bool IntGraph::is_directed () {
+bool IntGraphView::is_directed () const {
     return this->directed;
 }
 
-bool IntGraph::is_empty () {
-    return this->adjacency_list.empty();
+bool IntGraphView::is_empty () const {
+    return this->n_vertices == 0;
+}
+
+bool IntGraphView::has_in_edges () const {
+    return !this->directed || this->has_reverse_csr();
+}
+
+bool IntGraphView::has_reverse_csr () const {
+    return this->in_sources.size() == this->out_targets.size();
+}
+
+int IntGraphView::num_vertices () const {
+    return this->n_vertices;
+}
+
+std::size_t IntGraphView::num_edges () const {
+    return this->out_targets.size();
+}
+
+std::span <const int> IntGraphView::operator[] (int vertex) const {
+    return this->out_targets.subspan(
+        this->out_offsets[vertex],
+        this->out_offsets[vertex + 1] - this->out_offsets[vertex]
+    );
+}
+
+std::span <const int> IntGraphView::adjacent_in (int vertex) const {
+    if (!this->has_reverse_csr()) {
+        if (!this->directed)
+            return (*this)[vertex];
+        throw std::logic_error("Graph was frozen without in-edges!");
+    }
+
+    return this->in_sources.subspan(
+        this->in_offsets[vertex],
+        this->in_offsets[vertex + 1] - this->in_offsets[vertex]
+    );
+}
+
+std::span <const int> IntGraphView::adjacent_in_positions (int vertex) const {
+    if (!this->has_reverse_csr())
+        throw std::logic_error("Graph was frozen without in-edges!");
+
+    return this->in_positions.subspan(
+        this->in_offsets[vertex],
+        this->in_offsets[vertex + 1] - this->in_offsets[vertex]
+    );
+}
+
+int IntGraphView::in_deg (int vertex) const {
+    return this->in_offsets[vertex + 1] - this->in_offsets[vertex];
+}
+
+int IntGraphView::out_deg (int vertex) const {
+    return this->out_offsets[vertex + 1] - this->out_offsets[vertex];
+}
+
+
+// IntGraph container
+IntGraph::IntGraph (bool directed) {
+    this->directed = directed;
+}
+
+void IntGraph::show() const {
+    IntGraphView(*this).show();
+}
+
+bool IntGraph::is_directed () const {
+    return this->directed;
+}
+
+bool IntGraph::is_empty () const {
+    return this->n_vertices == 0;
+}
+
+bool IntGraph::is_frozen () const {
+    return this->pending_edges.empty();
+}
+
+bool IntGraph::has_in_edges () const {
+    return IntGraphView(*this).has_in_edges();
+}
+
+bool IntGraph::has_reverse_csr () const {
+    return IntGraphView(*this).has_reverse_csr();
 }
 
-int IntGraph::num_vertices () {
-    return this->adjacency_list.size();
+int IntGraph::num_vertices () const {
+    return this->n_vertices;
 }
 
-std::vector <int> IntGraph::vertices () {
+std::size_t IntGraph::num_edges () const {
+    return IntGraphView(*this).num_edges();
+}
+
+std::vector <int> IntGraph::vertices () const {
     std::vector <int> vertices(this->num_vertices());
     std::iota(vertices.begin(), vertices.end(), 0);
     return vertices;
 }
 
-std::vector<int>& IntGraph::operator[] (int vertex) {
-    return this->adjacency_list[vertex];
+std::span <const int> IntGraph::operator[] (int vertex) const {
+    return IntGraphView(*this)[vertex];
 }
 
-int IntGraph::in_deg (int vertex) {
-    return this->in_deg_list[vertex];
+std::span <const int> IntGraph::adjacent_in (int vertex) const {
+    return IntGraphView(*this).adjacent_in(vertex);
+}
+
+int IntGraph::in_deg (int vertex) const {
+    return IntGraphView(*this).in_deg(vertex);
+}
+
+int IntGraph::out_deg (int vertex) const {
+    return IntGraphView(*this).out_deg(vertex);
 }
 
 
 void IntGraph::push_vertices (int max_vertex) {
-    this->adjacency_list.resize(max_vertex, std::vector<int>());
-    this->in_deg_list.resize(max_vertex, 0);
+    if (max_vertex <= this->n_vertices)
+        return;
+
+    this->n_vertices = max_vertex;
+    this->out_offsets.resize(max_vertex + 1, this->out_offsets.back());
+    this->in_offsets.resize(max_vertex + 1, this->in_offsets.back());
 }
 
 
@@ -140,14 +608,230 @@ bool IntGraph::add_edge (int u, int v) {
     if (v < 0 || v >= this->num_vertices())
         return false;
 
-    this->adjacency_list[u].push_back(v);
-    this->in_deg_list[v]++;
-    if (!this->directed) {
-        this->adjacency_list[v].push_back(u);
-        this->in_deg_list[u]++;
+    this->pending_edges.push_back(std::make_pair(u, v));
+    return true;
+}
+
+void IntGraph::freeze (bool with_in_edges) {
+    // Rebuilds the CSR arrays from the already frozen and the pending edges
+    // Counting sort: the adjacency order of every vertex is the edge insertion order
+    int num_vertices = this->num_vertices();
+    std::vector <std::size_t> cursor;
+
+    if (!this->pending_edges.empty()) {
+        std::vector <std::size_t> out_offsets(num_vertices + 1, 0);
+        for (int v = 0; v < num_vertices; v++)
+            out_offsets[v + 1] = this->out_offsets[v + 1] - this->out_offsets[v];
+        for (auto [u, v] : this->pending_edges) {
+            out_offsets[u + 1]++;
+            if (!this->directed)
+                out_offsets[v + 1]++;
+        }
+        std::partial_sum(out_offsets.begin(), out_offsets.end(), out_offsets.begin());
+
+        std::vector <int> out_targets(out_offsets.back());
+        cursor.assign(out_offsets.begin(), out_offsets.end() - 1);
+        for (int v = 0; v < num_vertices; v++)
+            for (std::size_t i = this->out_offsets[v]; i < this->out_offsets[v + 1]; i++)
+                out_targets[cursor[v]++] = this->out_targets[i];
+        for (auto [u, v] : this->pending_edges) {
+            out_targets[cursor[u]++] = v;
+            if (!this->directed)
+                out_targets[cursor[v]++] = u;
+        }
+
+        this->out_offsets = std::move(out_offsets);
+        this->out_targets = std::move(out_targets);
+        this->pending_edges = std::vector<std::pair<int, int>>();
     }
 
-    return true;
+    this->in_sources.clear();
+    this->in_positions.clear();
+
+    std::vector <std::size_t> in_offsets(num_vertices + 1, 0);
+    for (int adj : this->out_targets)
+        in_offsets[adj + 1]++;
+    std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
+    this->in_offsets = std::move(in_offsets);
+
+    if (with_in_edges) {
+        this->in_sources.resize(this->out_targets.size());
+        this->in_positions.resize(this->out_targets.size());
+        cursor.assign(this->in_offsets.begin(), this->in_offsets.end() - 1);
+        for (int v = 0; v < num_vertices; v++) {
+            std::span <const int> adjacent = (*this)[v];
+            for (int i = 0; i < (int)adjacent.size(); i++) {
+                this->in_sources[cursor[adjacent[i]]] = v;
+                this->in_positions[cursor[adjacent[i]]++] = i;
+            }
+        }
+    }
+}
+
+void IntGraph::from_csr (bool directed, std::vector <std::size_t> out_offsets, std::vector <int> out_targets, bool with_in_edges) {
+    if (out_offsets.empty() || out_offsets.back() != out_targets.size())
+        throw std::invalid_argument("Error: Invalid CSR arrays");
+
+    *this = IntGraph(directed);
+    this->n_vertices = out_offsets.size() - 1;
+    this->out_offsets = std::move(out_offsets);
+    this->out_targets = std::move(out_targets);
+    this->freeze(with_in_edges); // the in-offsets and the reverse CSR
+}
+
+void IntGraph::from_edges (bool directed, int n_vertices, std::span <const std::pair <int, int>> edges, BuildOptions options) {
+    // LSD radix sort of the (u, v) entries with two digits of radix |V|, each a parallel counting sort:
+    // by v - its counts are the in-degrees and its output the sources grouped by their targets,
+    // then stably by u - its output are the CSR arrays with every neighbour list in ascending order
+    // Repeated neighbours and loops are dropped (if requested) by compacting the sorted lists
+    if (n_vertices < 0)
+        throw std::invalid_argument("Error: Invalid number of vertices");
+
+    GRAPH_PHASE("build");
+    parallel::Team team(options.num_threads);
+    std::vector <std::size_t> invalid(team.size(), SIZE_MAX); // first invalid edge of every thread
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(edges.size(), thread_id, team.size());
+        for (std::size_t i = first; i < last; i++) {
+            auto [u, v] = edges[i];
+            if (u < 0 || u >= n_vertices || v < 0 || v >= n_vertices) {
+                invalid[thread_id] = i;
+                break;
+            }
+        }
+    });
+
+    std::size_t first_invalid = *std::min_element(invalid.begin(), invalid.end());
+    if (first_invalid != SIZE_MAX) {
+        auto [u, v] = edges[first_invalid];
+        throw std::invalid_argument("Error: Could not add edge (" + std::to_string(u) + "," + std::to_string(v) + ")");
+    }
+
+    // The histograms take num_threads * |V| counters, so sparse graphs use fewer threads
+    std::size_t num_entries = directed ? edges.size() : 2 * edges.size();
+    int num_chunks = std::clamp<std::size_t>(num_entries / std::max(n_vertices, 1), 1, team.size());
+    std::vector <std::vector <std::uint32_t>> histogram(num_chunks);
+
+    auto counting_sort = [&](auto for_each_entry, std::vector <std::size_t> &offsets, std::vector <int> &values) {
+        // for_each_entry(first, last, function) calls function(key, value) for the entries [first, last)
+        team.run([&](int thread_id) {
+            if (thread_id >= num_chunks)
+                return;
+
+            std::vector <std::uint32_t> &counts = histogram[thread_id];
+            counts.assign(n_vertices, 0);
+            auto [first, last] = parallel::chunk(num_entries, thread_id, num_chunks);
+            for_each_entry(first, last, [&](int key, int) { counts[key]++; });
+        });
+
+        // the counts become the cursors of the chunks relative to the key offsets - the order of the chunks is kept
+        offsets.assign(n_vertices + 1, 0);
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(n_vertices, thread_id, team.size());
+            for (std::size_t key = first; key < last; key++) {
+                std::size_t count = 0;
+                for (std::vector <std::uint32_t> &counts : histogram) {
+                    std::uint32_t chunk_count = counts[key];
+                    counts[key] = count;
+                    count += chunk_count;
+                }
+                offsets[key + 1] = count;
+            }
+        });
+        parallel::partial_sum(team, offsets.begin(), offsets.end());
+
+        values.resize(num_entries);
+        team.run([&](int thread_id) {
+            if (thread_id >= num_chunks)
+                return;
+
+            std::vector <std::uint32_t> &cursor = histogram[thread_id];
+            auto [first, last] = parallel::chunk(num_entries, thread_id, num_chunks);
+            for_each_entry(first, last, [&](int key, int value) { values[offsets[key] + cursor[key]++] = value; });
+        });
+    };
+
+    // by v: the sources grouped by their targets (and the in-degrees)
+    std::vector <std::size_t> in_offsets;
+    std::vector <int> in_sources;
+    counting_sort([&](std::size_t first, std::size_t last, auto &&function) {
+        for (std::size_t i = first; i < last; i++) {
+            auto [u, v] = edges[directed ? i : i / 2];
+            if (directed || i % 2 == 0)
+                function(v, u);
+            else
+                function(u, v);
+        }
+    }, in_offsets, in_sources);
+
+    // by u: the targets of an entry follow from the in-offsets
+    std::vector <std::size_t> out_offsets;
+    std::vector <int> out_targets;
+    counting_sort([&](std::size_t first, std::size_t last, auto &&function) {
+        int v = std::upper_bound(in_offsets.begin(), in_offsets.end(), first) - in_offsets.begin() - 1;
+        for (std::size_t i = first; i < last; i++) {
+            while (in_offsets[v + 1] <= i)
+                v++;
+            function(in_sources[i], v);
+        }
+    }, out_offsets, out_targets);
+    in_sources = std::vector<int>();
+
+    if (options.deduplicate || options.remove_loops) {
+        // compaction: the kept degrees, their offsets and a copy of the kept neighbours (with their in-degrees)
+        auto is_kept = [&](int v, std::size_t i) {
+            if (options.remove_loops && out_targets[i] == v)
+                return false;
+            return !options.deduplicate || i == out_offsets[v] || out_targets[i] != out_targets[i - 1];
+        };
+
+        std::vector <std::size_t> kept_offsets(n_vertices + 1, 0);
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(n_vertices, thread_id, team.size());
+            for (std::size_t v = first; v < last; v++)
+                for (std::size_t i = out_offsets[v]; i < out_offsets[v + 1]; i++)
+                    kept_offsets[v + 1] += is_kept(v, i);
+        });
+        parallel::partial_sum(team, kept_offsets.begin(), kept_offsets.end());
+
+        std::vector <int> kept_targets(kept_offsets.back());
+        team.run([&](int thread_id) {
+            if (thread_id >= num_chunks)
+                return;
+
+            std::vector <std::uint32_t> &counts = histogram[thread_id];
+            std::fill(counts.begin(), counts.end(), 0);
+            auto [first, last] = parallel::chunk(n_vertices, thread_id, num_chunks);
+            for (std::size_t v = first; v < last; v++) {
+                std::size_t position = kept_offsets[v];
+                for (std::size_t i = out_offsets[v]; i < out_offsets[v + 1]; i++)
+                    if (is_kept(v, i)) {
+                        kept_targets[position++] = out_targets[i];
+                        counts[out_targets[i]]++;
+                    }
+            }
+        });
+
+        in_offsets.assign(n_vertices + 1, 0);
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(n_vertices, thread_id, team.size());
+            for (std::size_t v = first; v < last; v++)
+                for (std::vector <std::uint32_t> &counts : histogram)
+                    in_offsets[v + 1] += counts[v];
+        });
+        parallel::partial_sum(team, in_offsets.begin(), in_offsets.end());
+
+        out_offsets = std::move(kept_offsets);
+        out_targets = std::move(kept_targets);
+    }
+
+    *this = IntGraph(directed);
+    this->n_vertices = n_vertices;
+    this->out_offsets = std::move(out_offsets);
+    this->out_targets = std::move(out_targets);
+    this->in_offsets = directed ? std::move(in_offsets) : this->out_offsets;
+    if (options.with_in_edges)
+        this->freeze(true);
 }
 
 // IntGraph utils (reading from file)
@@ -158,24 +842,21 @@ File structure:
 n - number of vertices (the IntGraph will have vertices numbered [1 ... n])
 m - number of edges
 list of m edges in a "u v" format
-*/
-void IntGraph::from_file (std::string file_name) {
-    std::cout << "Reading data...\n";
-    std::ifstream infile;
-    infile.open(file_name);
-
-    if (!infile.is_open())
-        throw std::invalid_argument("Could not open: " + file_name + "!");
 
+The file is memory mapped and the edge list is split into byte ranges parsed by the threads of a team.
+The edges are placed in the CSR arrays by a parallel counting sort: per-thread degree histograms
+turned into per-thread cursors by a prefix sum, so the adjacency order is the order of the file.
+*/
+void graph::read_header (std::istream &infile, bool &directed, int &n_vertices, int &n_edges) {
     char g_type;
     infile >> g_type;
     switch (g_type) {
         case 'D': {
-            this->directed = true;
+            directed = true;
             break;
         }
         case 'U': {
-            this->directed = false;
+            directed = false;
             break;
         }
         default: {
@@ -184,217 +865,1163 @@ void IntGraph::from_file (std::string file_name) {
         }
     }
 
-    int n_vertices, n_edges;
     infile >> n_vertices >> n_edges;
+}
+
+bool graph::_is_space (char c) {
+    // the characters skipped by `operator >>`
+    return c == ' ' || (unsigned)(c - '\t') < 5u;
+}
+
+bool graph::_scan_int (const char *&it, const char *end, int &value) {
+    // parses the integer after the whitespace at `it` - false if there is no valid int
+    while (it < end && graph::_is_space(*it))
+        it++;
+
+    bool negative = it < end && *it == '-';
+    it += negative;
+
+    const char *digits = it;
+    std::uint64_t magnitude = 0;
+    while (it < end && it - digits < 11 && (unsigned)(*it - '0') < 10u)
+        magnitude = magnitude * 10 + (*it++ - '0');
+
+    if (it == digits || (it < end && !graph::_is_space(*it)) || magnitude > INT_MAX)
+        return false;
+
+    value = negative ? -(int)magnitude : (int)magnitude;
+    return true;
+}
+
+std::size_t graph::_parse_header (std::span <const char> bytes, bool &directed, int &n_vertices, int &n_edges) {
+    // the same header as `read_header` - returns the offset of the edge list
+    const char *it = bytes.data();
+    const char *end = it + bytes.size();
+    while (it < end && graph::_is_space(*it))
+        it++;
+
+    char g_type = it < end ? *it++ : '\0';
+    switch (g_type) {
+        case 'D': {
+            directed = true;
+            break;
+        }
+        case 'U': {
+            directed = false;
+            break;
+        }
+        default: {
+            std::string message = "Invalid Graph type (" + std::to_string(g_type) + ") - must be 'U' or 'D'";
+            throw std::invalid_argument(message);
+        }
+    }
+
+    if (!graph::_scan_int(it, end, n_vertices) || !graph::_scan_int(it, end, n_edges) || n_vertices < 0 || n_edges < 0)
+        throw std::invalid_argument("Error: Invalid number of vertices or edges");
+
+    return it - bytes.data();
+}
+
+void graph::_parse_tokens (std::span <const char> bytes, std::size_t first, std::size_t last, _tokens_s &tokens) {
+    // parses the integers which start in [first, last) - the last one may end after `last`
+    const char *it = bytes.data() + first;
+    const char *range_end = bytes.data() + last;
+    const char *end = bytes.data() + bytes.size();
+
+    // a token cut by `first` belongs to the previous range
+    if (first > 0)
+        while (it < range_end && !graph::_is_space(*(it - 1)))
+            it++;
+
+    tokens.values.reserve((last - first) / 4);
+    int value;
+    while (true) {
+        while (it < range_end && graph::_is_space(*it))
+            it++;
+        if (it >= range_end)
+            return;
+
+        if (!graph::_scan_int(it, end, value)) {
+            tokens.malformed = true;
+            return;
+        }
+        tokens.values.push_back(value);
+    }
+}
+
+void IntGraph::from_file (std::string file_name, bool with_in_edges, int num_threads) {
+    std::cout << "Reading data...\n";
+    GRAPH_PHASE_BEGIN(parse, "parse");
+    MappedFile file(file_name);
+    std::span <const char> bytes = file.data();
+
+    bool directed;
+    int n_vertices, n_edges;
+    std::size_t edges_offset = graph::_parse_header(bytes, directed, n_vertices, n_edges);
+    *this = IntGraph(directed);
     this->push_vertices(n_vertices);
 
-    int u, v;
-    for (int i = 0; i < n_edges; i++) {
-        infile >> u >> v;
-        if (!this->add_edge(u - 1, v - 1)) {
+    // parsing: the byte ranges of the edge list
+    parallel::Team team(num_threads);
+    int num_ranges = team.size();
+    std::vector <_tokens_s> tokens(num_ranges);
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(bytes.size() - edges_offset, thread_id, num_ranges);
+        graph::_parse_tokens(bytes, edges_offset + first, edges_offset + last, tokens[thread_id]);
+    });
+
+    // a malformed token ends the input (as it stops `operator >>`)
+    for (int r = 0; r < num_ranges; r++)
+        if (tokens[r].malformed) {
+            tokens.resize(r + 1);
+            num_ranges = r + 1;
+        }
+
+    // an edge cut by a range boundary is completed with the first value of the next non-empty range
+    for (int r = 0; r < num_ranges; r++) {
+        if ((tokens[r].values.size() - tokens[r].begin) % 2 == 0)
+            continue;
+        for (int next = r + 1; next < num_ranges; next++)
+            if (tokens[next].begin < tokens[next].values.size()) {
+                tokens[r].values.push_back(tokens[next].values[tokens[next].begin++]);
+                break;
+            }
+    }
+
+    // edges [edge_begin[r], edge_begin[r + 1]) are stored in the range r - only the first n_edges are used
+    std::vector <std::size_t> edge_begin(num_ranges + 1, 0);
+    for (int r = 0; r < num_ranges; r++) {
+        std::size_t range_edges = (tokens[r].values.size() - tokens[r].begin) / 2;
+        edge_begin[r + 1] = std::min<std::size_t>(edge_begin[r] + range_edges, n_edges);
+    }
+    if (edge_begin.back() < std::size_t(n_edges))
+        throw std::invalid_argument("Error: Expected " + std::to_string(n_edges) + " edges");
+
+    auto for_each_edge = [&](std::size_t first, std::size_t last, auto &&function) {
+        // calls function(index, u, v) for the edges [first, last) of the file
+        int r = std::upper_bound(edge_begin.begin(), edge_begin.end(), first) - edge_begin.begin() - 1;
+        for (std::size_t i = first; i < last && r < num_ranges; r++) {
+            const int *edge = tokens[r].values.data() + tokens[r].begin + 2 * (i - edge_begin[r]);
+            for (; i < last && i < edge_begin[r + 1]; i++, edge += 2)
+                function(i, edge[0], edge[1]);
+        }
+    };
+
+    GRAPH_PHASE_END(parse);
+
+    // counting: every thread counts its edges in its own histogram
+    GRAPH_PHASE("build");
+    // The histograms take num_threads * |V| counters, so sparse graphs use fewer threads
+    std::size_t num_entries = this->directed ? n_edges : 2 * std::size_t(n_edges);
+    int num_threads_used = std::clamp<std::size_t>(num_entries / std::max(n_vertices, 1), 1, team.size());
+    std::vector <std::vector <std::uint32_t>> histogram(num_threads_used);
+    std::vector <std::size_t> invalid(num_threads_used, SIZE_MAX); // first invalid edge of every thread
+    team.run([&](int thread_id) {
+        if (thread_id >= num_threads_used)
+            return;
+
+        std::vector <std::uint32_t> &counts = histogram[thread_id];
+        counts.assign(n_vertices, 0);
+        auto [first, last] = parallel::chunk(n_edges, thread_id, num_threads_used);
+        for_each_edge(first, last, [&](std::size_t i, int u, int v) {
+            if (u < 1 || u > n_vertices || v < 1 || v > n_vertices) {
+                invalid[thread_id] = std::min(invalid[thread_id], i);
+                return;
+            }
+
+            counts[u - 1]++;
+            if (!this->directed)
+                counts[v - 1]++;
+        });
+    });
+
+    std::size_t first_invalid = *std::min_element(invalid.begin(), invalid.end());
+    if (first_invalid != SIZE_MAX)
+        for_each_edge(first_invalid, first_invalid + 1, [](std::size_t, int u, int v) {
             std::string message = "Error: Could not add edge (" + std::to_string(u) + "," + std::to_string(v) + ")";
             throw std::invalid_argument(message);
-        }
+        });
+
+    // histograms -> per-thread cursors relative to the vertex offsets and vertex degrees
+    auto scan_histograms = [&](std::vector <std::size_t> &offsets) {
+        offsets.assign(n_vertices + 1, 0);
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(n_vertices, thread_id, team.size());
+            for (std::size_t v = first; v < last; v++) {
+                std::size_t degree = 0;
+                for (std::vector <std::uint32_t> &counts : histogram) {
+                    std::uint32_t count = counts[v];
+                    counts[v] = degree;
+                    degree += count;
+                }
+                offsets[v + 1] = degree;
+            }
+        });
+        parallel::partial_sum(team, offsets.begin(), offsets.end());
+    };
+
+    // placement: every thread writes its edges at its own cursors
+    std::vector <std::size_t> out_offsets;
+    scan_histograms(out_offsets);
+    std::vector <int> out_targets(out_offsets.back());
+    team.run([&](int thread_id) {
+        if (thread_id >= num_threads_used)
+            return;
+
+        std::vector <std::uint32_t> &cursor = histogram[thread_id];
+        auto [first, last] = parallel::chunk(n_edges, thread_id, num_threads_used);
+        for_each_edge(first, last, [&](std::size_t, int u, int v) {
+            out_targets[out_offsets[u - 1] + cursor[u - 1]++] = v - 1;
+            if (!this->directed)
+                out_targets[out_offsets[v - 1] + cursor[v - 1]++] = u - 1;
+        });
+    });
+
+    // in-degrees: the same histograms count the edge targets
+    std::vector <std::size_t> in_offsets;
+    if (this->directed) {
+        team.run([&](int thread_id) {
+            if (thread_id >= num_threads_used)
+                return;
+
+            std::vector <std::uint32_t> &counts = histogram[thread_id];
+            std::fill(counts.begin(), counts.end(), 0);
+            auto [first, last] = parallel::chunk(n_edges, thread_id, num_threads_used);
+            for_each_edge(first, last, [&](std::size_t, int, int v) {
+                counts[v - 1]++;
+            });
+        });
+        scan_histograms(in_offsets);
     }
+    else
+        in_offsets = out_offsets;
+
+    this->out_offsets = std::move(out_offsets);
+    this->out_targets = std::move(out_targets);
+    this->in_offsets = std::move(in_offsets);
+    if (with_in_edges) 
+        this->freeze(true);
 
     std::cout << "Success!\n";
 }
 
 
 
+// Components
+void Components::group () {
+    // counting sort of the vertices by their component index
+    this->offsets.assign(this->num_components + 1, 0);
+    for (int componnent : this->component_idx)
+        this->offsets[componnent + 1]++;
+    std::partial_sum(this->offsets.begin(), this->offsets.end(), this->offsets.begin());
+
+    this->vertices.resize(this->component_idx.size());
+    std::vector <int> cursor(this->offsets.begin(), this->offsets.end() - 1);
+    for (int v = 0; v < (int)this->component_idx.size(); v++)
+        this->vertices[cursor[this->component_idx[v]]++] = v;
+}
+
+bool Components::is_grouped () const {
+    return this->offsets.size() == std::size_t(this->num_components + 1);
+}
+
+std::span <const int> Components::operator[] (int component) const {
+    return std::span<const int>(this->vertices).subspan(
+        this->offsets[component], this->offsets[component + 1] - this->offsets[component]
+    );
+}
+
+
+
+// Schedule
+int Schedule::num_levels () const {
+    return this->level_offsets.size() - 1;
+}
+
+std::span <const int> Schedule::operator[] (int level) const {
+    return std::span<const int>(this->order).subspan(
+        this->level_offsets[level], this->level_offsets[level + 1] - this->level_offsets[level]
+    );
+}
+
+
+
+// SearchResult
+int SearchResult::num_vertices () const {
+    return this->parent_idx.size();
+}
+
+int SearchResult::num_roots () const {
+    return std::count(this->parent_idx.begin(), this->parent_idx.end(), -1);
+}
+
+bool SearchResult::has_times () const {
+    return !this->discovery.empty();
+}
+
+IntGraph SearchResult::tree () const {
+    // counting sort of the vertices by their parents - straight into the CSR arrays
+    int num_vertices = this->num_vertices();
+    std::vector <std::size_t> out_offsets(num_vertices + 1, 0);
+    for (int parent : this->parent_idx)
+        if (parent != -1)
+            out_offsets[parent + 1]++;
+    std::partial_sum(out_offsets.begin(), out_offsets.end(), out_offsets.begin());
+
+    std::vector <int> out_targets(out_offsets.back());
+    std::vector <std::size_t> cursor(out_offsets.begin(), out_offsets.end() - 1);
+    for (int v = 0; v < num_vertices; v++)
+        if (this->parent_idx[v] != -1)
+            out_targets[cursor[this->parent_idx[v]]++] = v;
+
+    IntGraph search_tree;
+    search_tree.from_csr(true, std::move(out_offsets), std::move(out_targets));
+    return search_tree;
+}
+
+
+
 // Graph algorithms
+// traversal engine
+bool algorithm::Stack::empty () const {
+    return this->items.empty();
+}
+
+std::size_t algorithm::Stack::size () const {
+    return this->items.size();
+}
+
+void algorithm::Stack::push (int vertex) {
+    this->items.push_back(vertex);
+}
+
+int algorithm::Stack::pop () {
+    int vertex = this->items.back();
+    this->items.pop_back();
+    return vertex;
+}
+
+bool algorithm::Queue::empty () const {
+    return this->head == this->items.size();
+}
+
+std::size_t algorithm::Queue::size () const {
+    return this->items.size() - this->head;
+}
+
+void algorithm::Queue::push (int vertex) {
+    this->items.push_back(vertex);
+}
+
+int algorithm::Queue::pop () {
+    int vertex = this->items[this->head++];
+    if (this->head == this->items.size()) {
+        // the storage is reused by the next root
+        this->items.clear();
+        this->head = 0;
+    }
+    return vertex;
+}
+
+template <typename Container, typename Visitor, typename Graph>
+void algorithm::traverse (const Graph &graph, Container &container, Visitor &visitor) {
+    // a nested container finishes a vertex when its marker (~vertex) pushed below its edges is popped
+    constexpr bool with_finish = requires (int v) { visitor.on_finish(v); };
+    constexpr bool with_markers = with_finish && Container::nested;
+
+    while (!container.empty()) {
+        int v = container.pop();
+        if constexpr (with_markers) {
+            if (v < 0) {
+                visitor.on_finish(~v);
+                continue;
+            }
+        }
+
+        if constexpr (requires { visitor.on_discover(v); })
+            if (!visitor.on_discover(v))
+                continue;
+        GRAPH_COUNT(vertices_visited, 1);
+
+        if constexpr (with_markers)
+            container.push(~v);
+
+        for (int adj : graph[v]) {
+            GRAPH_COUNT(edges_scanned, 1);
+            if constexpr (requires { visitor.on_edge(v, adj); }) {
+                if (visitor.on_edge(v, adj))
+                    container.push(adj);
+            }
+            else
+                container.push(adj);
+        }
+        GRAPH_HIGH_WATER(max_depth, container.size());
+
+        if constexpr (with_finish && !with_markers)
+            visitor.on_finish(v);
+    }
+}
+
+
 // dfs, bfs
-std::pair <std::vector <int>, IntGraph> algorithm::search (IntGraph graph, bool depth_first) {
+template <bool WithTimes>
+bool algorithm::_search_s<WithTimes>::on_discover (int v) {
+    if (this->visited[v])
+        return false;
+
+    this->visited[v] = true;
+    this->result.order.push_back(v);
+    if constexpr (WithTimes)
+        this->result.discovery[v] = this->clock++;
+    return true;
+}
+
+template <bool WithTimes>
+bool algorithm::_search_s<WithTimes>::on_edge (int v, int adj) {
+    if (this->visited[adj])
+        return false;
+
+    if (this->result.parent_idx[adj] == -1)
+        this->result.parent_idx[adj] = v;
+    return true;
+}
+
+template <bool WithTimes>
+void algorithm::_search_s<WithTimes>::on_finish (int v) requires WithTimes {
+    this->result.finish[v] = this->clock++;
+}
+
+template <typename Container, bool WithTimes, typename Graph>
+SearchResult algorithm::_search (const Graph &graph) {
     int num_vertices = graph.num_vertices();
-    std::vector <bool> visited = std::vector<bool>(num_vertices, false);
-    std::vector <int> parent_idx = std::vector<int>(num_vertices, -1);
-    std::vector <int> search_order;
-
-    algorithm::_container_f cf;
-    std::deque <int> container; // dfs: stack, bfs: queue
-    if (depth_first) {
-        cf.first = [](std::deque<int>& container) { return container.back(); };
-        cf.pop_first = [](std::deque<int>& container) { container.pop_back(); };
+    algorithm::_search_s<WithTimes> ss = {
+        .visited = std::vector<bool>(num_vertices, false),
+        .result = {
+            .order = std::vector<int>(),
+            .parent_idx = std::vector<int>(num_vertices, -1),
+            .discovery = std::vector<int>(WithTimes ? num_vertices : 0),
+            .finish = std::vector<int>(WithTimes ? num_vertices : 0)
+        }
+    };
+    ss.result.order.reserve(num_vertices);
+
+    Container container;
+    for (int vertex = 0; vertex < num_vertices; vertex++)
+        if (!ss.visited[vertex]) {
+            container.push(vertex);
+            algorithm::traverse(graph, container, ss);
+        }
+
+    return std::move(ss.result);
+}
+
+SearchResult algorithm::search (IntGraphView graph, bool depth_first, bool with_times) {
+    // the only runtime dispatch - each combination is a separate instantiation
+    if (depth_first)
+        return with_times ? algorithm::_search<Stack, true>(graph) : algorithm::_search<Stack, false>(graph);
+    return with_times ? algorithm::_search<Queue, true>(graph) : algorithm::_search<Queue, false>(graph);
+}
+
+
+// direction-optimizing bfs
+algorithm::_bitmap::_bitmap (int size) {
+    this->words.assign((size + 63) / 64, 0);
+}
+
+bool algorithm::_bitmap::test (int index) const {
+    return (this->words[index >> 6] >> (index & 63)) & 1;
+}
+
+void algorithm::_bitmap::set (int index) {
+    this->words[index >> 6] |= std::uint64_t(1) << (index & 63);
+}
+
+void algorithm::_bitmap::reset (int index) {
+    this->words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+}
+
+void algorithm::_dobfs_visit (IntGraphView graph, algorithm::_dobfs_s &bs, int v, int parent) {
+    bs.visited.set(v);
+    bs.parent_idx[v] = parent;
+    bs.order_idx[v] = bs.search_order.size();
+    bs.search_order.push_back(v);
+    bs.unexplored_edges -= graph.in_deg(v);
+    GRAPH_COUNT(vertices_visited, 1);
+}
+
+void algorithm::_dobfs_top_down (
+    IntGraphView graph, algorithm::_dobfs_s &bs, std::size_t level_begin, std::size_t level_end
+) {
+    GRAPH_PHASE("top-down level");
+    for (std::size_t i = level_begin; i < level_end; i++) {
+        int v = bs.search_order[i];
+        GRAPH_COUNT(edges_scanned, graph.out_deg(v));
+        for (int adj : graph[v])
+            if (!bs.visited.test(adj))
+                algorithm::_dobfs_visit(graph, bs, adj, v);
     }
-    else {
-        cf.first = [](std::deque<int>& container) { return container.front(); };
-        cf.pop_first = [](std::deque<int>& container) { container.pop_front(); };
+}
+
+void algorithm::_dobfs_bottom_up (
+    IntGraphView graph, algorithm::_dobfs_s &bs, std::size_t level_begin, std::size_t level_end
+) {
+    // every unvisited vertex looks for its parent among its in-neighbours
+    // the parent is the in-neighbour visited first - the one a top-down step would use -
+    // and the vertex is ranked by (parent's order, its position in the parent's adjacency list)
+    GRAPH_PHASE("bottom-up level");
+    for (std::size_t i = level_begin; i < level_end; i++)
+        bs.frontier.set(bs.search_order[i]);
+
+    int num_vertices = graph.num_vertices();
+    int num_words = bs.visited.words.size();
+    for (int word = 0; word < num_words; word++) {
+        std::uint64_t unvisited = ~bs.visited.words[word];
+        while (unvisited) {
+            int v = word * 64 + std::countr_zero(unvisited);
+            unvisited &= unvisited - 1;
+            if (v >= num_vertices)
+                break;
+
+            std::span <const int> adjacent = graph.adjacent_in(v);
+            std::span <const int> positions = graph.adjacent_in_positions(v);
+            GRAPH_COUNT(edges_scanned, adjacent.size());
+            int parent = -1;
+            std::uint64_t rank = UINT64_MAX;
+            for (std::size_t i = 0; i < adjacent.size(); i++) {
+                if (!bs.frontier.test(adjacent[i]))
+                    continue;
+
+                std::uint64_t adj_rank = (std::uint64_t(bs.order_idx[adjacent[i]]) << 32) | std::uint32_t(positions[i]);
+                if (adj_rank < rank) {
+                    rank = adj_rank;
+                    parent = adjacent[i];
+                }
+            }
+
+            if (parent != -1) {
+                bs.parent_idx[v] = parent;
+                bs.discovered.push_back(std::make_pair(rank, v));
+            }
+        }
     }
 
+    for (std::size_t i = level_begin; i < level_end; i++)
+        bs.frontier.reset(bs.search_order[i]);
+
+    std::sort(bs.discovered.begin(), bs.discovered.end());
+    for (auto [rank, v] : bs.discovered)
+        algorithm::_dobfs_visit(graph, bs, v, bs.parent_idx[v]);
+    bs.discovered.clear();
+}
+
+SearchResult algorithm::direction_optimizing_bfs (IntGraphView graph) {
+    if (!graph.has_reverse_csr())
+        throw std::invalid_argument("Graph was frozen without in-edges!");
+
+    int num_vertices = graph.num_vertices();
+    algorithm::_dobfs_s bs = {
+        .visited = algorithm::_bitmap(num_vertices),
+        .frontier = algorithm::_bitmap(num_vertices),
+        .parent_idx = std::vector<int>(num_vertices, -1),
+        .order_idx = std::vector<int>(num_vertices, -1),
+        .discovered = std::vector<std::pair<std::uint64_t, int>>(),
+        .search_order = std::vector<int>(),
+        .unexplored_edges = graph.num_edges()
+    };
+    bs.search_order.reserve(num_vertices);
+
     for (int vertex = 0; vertex < num_vertices; vertex++) 
-        if (!visited[vertex]) {
-            container.push_back(vertex);
-            while (!container.empty()) {
-                // get first element from the container
-                int v = cf.first(container);
-                cf.pop_first(container);
-                
-                if (!visited[v]) {
-                    visited[v] = true;
-                    search_order.push_back(v);
-
-                    // push adjacent vertices to the container
-                    for (int adj_v : graph[v]) {
-                        if (!visited[adj_v]) {
-                            container.push_back(adj_v);
-                            if (parent_idx[adj_v] == -1) 
-                                parent_idx[adj_v] = v;
-                        }
-                    }
+        if (!bs.visited.test(vertex)) {
+            algorithm::_dobfs_visit(graph, bs, vertex, -1);
+
+            std::size_t level_begin = bs.search_order.size() - 1;
+            while (level_begin < bs.search_order.size()) {
+                std::size_t level_end = bs.search_order.size();
+                GRAPH_FRONTIER(level_end - level_begin);
+                std::size_t frontier_edges = 0;
+                for (std::size_t i = level_begin; i < level_end; i++)
+                    frontier_edges += graph.out_deg(bs.search_order[i]);
+
+                if (frontier_edges > bs.unexplored_edges)
+                    algorithm::_dobfs_bottom_up(graph, bs, level_begin, level_end);
+                else
+                    algorithm::_dobfs_top_down(graph, bs, level_begin, level_end);
+
+                level_begin = level_end;
+            }
+        }
+
+    return SearchResult{.order = std::move(bs.search_order), .parent_idx = std::move(bs.parent_idx)};
+}
+
+
+// parallel bfs
+void algorithm::_pbfs_expand (
+    IntGraphView graph, algorithm::_pbfs_s &ps, std::size_t level_end, int thread_id
+) {
+    std::vector <std::pair <std::uint64_t, int>> &discovered = ps.discovered[thread_id];
+    std::size_t first;
+    while ((first = ps.next_chunk.fetch_add(ps.chunk_size)) < level_end) {
+        std::size_t last = std::min(first + ps.chunk_size, level_end);
+        for (std::size_t i = first; i < last; i++) {
+            std::span <const int> adjacent = graph[ps.search_order[i]];
+            GRAPH_COUNT(edges_scanned, adjacent.size());
+            for (std::size_t pos = 0; pos < adjacent.size(); pos++) {
+                // vertices of the previous levels always have a lower rank
+                std::atomic_ref <std::uint64_t> rank(ps.parent_rank[adjacent[pos]]);
+                std::uint64_t adj_rank = (std::uint64_t(i) << 32) | pos;
+                std::uint64_t current = rank.load(std::memory_order_relaxed);
+                if (ps.deterministic) {
+                    while (adj_rank < current && !rank.compare_exchange_weak(current, adj_rank, std::memory_order_relaxed));
+                    if (current == ps.unvisited)
+                        discovered.push_back(std::make_pair(adj_rank, adjacent[pos]));
                 }
+                else if (current == ps.unvisited && rank.compare_exchange_strong(current, adj_rank, std::memory_order_relaxed))
+                    discovered.push_back(std::make_pair(adj_rank, adjacent[pos]));
+            }
+        }
+    }
+}
+
+void algorithm::_pbfs_emit (algorithm::_pbfs_s &ps, const std::pair <std::uint64_t, int> &vertex, std::size_t index) {
+    ps.search_order[index] = vertex.second;
+    ps.parent_idx[vertex.second] = ps.search_order[ps.parent_rank[vertex.second] >> 32];
+}
+
+void algorithm::_pbfs_level (
+    IntGraphView graph, algorithm::_pbfs_s &ps, parallel::Team &team, std::size_t level_begin, std::size_t level_end
+) {
+    ps.next_chunk = level_begin;
+    if (level_end - level_begin < ps.sequential_limit) {
+        // a single thread claims the vertices in the rank order
+        algorithm::_pbfs_expand(graph, ps, level_end, 0);
+        for (const auto &vertex : ps.discovered[0])
+            algorithm::_pbfs_emit(ps, vertex, ps.size++);
+        ps.discovered[0].clear();
+        return;
+    }
+
+    int num_threads = team.size();
+    team.run([&](int thread_id) {
+        algorithm::_pbfs_expand(graph, ps, level_end, thread_id);
+    });
+
+    // thread-local frontiers concatenated at their prefix sum offsets
+    std::size_t level_size = 0;
+    for (int thread_id = 0; thread_id < num_threads; thread_id++) {
+        ps.offsets[thread_id] = level_size;
+        level_size += ps.discovered[thread_id].size();
+    }
+
+    if (!ps.deterministic) {
+        team.run([&](int thread_id) {
+            std::size_t index = ps.size + ps.offsets[thread_id];
+            for (const auto &vertex : ps.discovered[thread_id])
+                algorithm::_pbfs_emit(ps, vertex, index++);
+            ps.discovered[thread_id].clear();
+        });
+    }
+    else {
+        // the final ranks are known only after the whole level was expanded
+        ps.next.resize(level_size);
+        team.run([&](int thread_id) {
+            std::size_t index = ps.offsets[thread_id];
+            for (auto [rank, v] : ps.discovered[thread_id])
+                ps.next[index++] = std::make_pair(ps.parent_rank[v], v);
+            ps.discovered[thread_id].clear();
+        });
+
+        parallel::sort(team, ps.next.begin(), ps.next.end());
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(level_size, thread_id, num_threads);
+            for (std::size_t i = first; i < last; i++)
+                algorithm::_pbfs_emit(ps, ps.next[i], ps.size + i);
+        });
+    }
+
+    ps.size += level_size;
+}
+
+SearchResult algorithm::parallel_bfs (IntGraphView graph, bool deterministic, int num_threads) {
+    int num_vertices = graph.num_vertices();
+    parallel::Team team(num_threads);
+    algorithm::_pbfs_s ps = {
+        .deterministic = deterministic,
+        .parent_rank = std::vector<std::uint64_t>(num_vertices, algorithm::_pbfs_s::unvisited),
+        .parent_idx = std::vector<int>(num_vertices, -1),
+        .search_order = std::vector<int>(num_vertices),
+        .size = 0,
+        .discovered = std::vector<std::vector<std::pair<std::uint64_t, int>>>(team.size()),
+        .offsets = std::vector<std::size_t>(team.size()),
+        .next = std::vector<std::pair<std::uint64_t, int>>(),
+        .next_chunk = 0
+    };
+
+    for (int vertex = 0; vertex < num_vertices; vertex++) 
+        if (ps.parent_rank[vertex] == ps.unvisited) {
+            ps.parent_rank[vertex] = 0;
+            ps.search_order[ps.size++] = vertex;
+
+            std::size_t level_begin = ps.size - 1;
+            while (level_begin < ps.size) {
+                std::size_t level_end = ps.size;
+                GRAPH_FRONTIER(level_end - level_begin);
+                GRAPH_PHASE("level");
+                algorithm::_pbfs_level(graph, ps, team, level_begin, level_end);
+                level_begin = level_end;
             }
         }
-            
-    IntGraph search_tree(true);
-    search_tree.push_vertices(num_vertices);
-    for (int v = 0; v < num_vertices; v++) 
-        search_tree.add_edge(parent_idx[v], v);
 
-    return std::make_pair(search_order, search_tree);
+    return SearchResult{.order = std::move(ps.search_order), .parent_idx = std::move(ps.parent_idx)};
 }
 
 
 // finding IntGraph's topological order or acyclicity
-std::vector <int> algorithm::topological_sort (IntGraph graph) {
+bool algorithm::_ts_s::on_discover (int v) {
+    this->topological_order.push_back(v);
+    return true;
+}
+
+bool algorithm::_ts_s::on_edge (int, int adj) {
+    return --this->in_deg[adj] == 0;
+}
+
+std::vector <int> algorithm::topological_sort (IntGraphView graph) {
     if (!graph.is_directed()) 
         throw std::invalid_argument("Graph is NOT directed!");
 
     int num_vertices = graph.num_vertices();
+    algorithm::_ts_s ts = {.in_deg = std::vector<int>(num_vertices)};
+    ts.topological_order.reserve(num_vertices);
 
-    std::vector <int> in_deg(num_vertices);
-    for (int v = 0; v < num_vertices; v++) 
-        in_deg[v] = graph.in_deg(v);
-
-    std::queue <int> src_queue; // indeices of source vertices
-    for (int v = 0; v < num_vertices; v++)
-        if (!in_deg[v])
+    Queue src_queue; // indices of source vertices
+    for (int v = 0; v < num_vertices; v++) {
+        ts.in_deg[v] = graph.in_deg(v);
+        if (!ts.in_deg[v])
             src_queue.push(v);
+    }
+    algorithm::traverse(graph, src_queue, ts);
+
+    if ((int)ts.topological_order.size() != num_vertices) 
+        throw std::invalid_argument("Graph is NOT acyclic!");
+
+    return std::move(ts.topological_order);
+}
+
+
+// finding IntGraph's topological order by whole in-degree-zero wavefronts
+void algorithm::_wts_gather (parallel::Team &team, algorithm::_wts_s &ts) {
+    // thread-local levels concatenated at their prefix sum offsets and sorted
+    std::size_t level_begin = ts.size;
+    std::vector <std::size_t> offsets(team.size() + 1, ts.size);
+    for (int thread_id = 0; thread_id < team.size(); thread_id++)
+        offsets[thread_id + 1] = offsets[thread_id] + ts.next[thread_id].size();
+    ts.size = offsets.back();
+
+    team.run([&](int thread_id) {
+        std::copy(ts.next[thread_id].begin(), ts.next[thread_id].end(), ts.order.begin() + offsets[thread_id]);
+        ts.next[thread_id].clear();
+    });
+    parallel::sort(team, ts.order.begin() + level_begin, ts.order.begin() + ts.size);
+}
 
-    std::vector <int> topological_order;
-    while (!src_queue.empty()) {
-        int src = src_queue.front();
-        src_queue.pop();
-        topological_order.push_back(src);
+void algorithm::_wts_level (
+    IntGraphView graph, parallel::Team &team, algorithm::_wts_s &ts, std::size_t level_begin, std::size_t level_end
+) {
+    if (level_end - level_begin < ts.sequential_limit) {
+        for (std::size_t i = level_begin; i < level_end; i++)
+            for (int adj : graph[ts.order[i]])
+                if (--ts.in_deg[adj] == 0)
+                    ts.order[ts.size++] = adj;
+        std::sort(ts.order.begin() + level_end, ts.order.begin() + ts.size);
+        return;
+    }
 
-        for (int adj : graph[src]) {
-            if (--in_deg[adj] == 0)
-                src_queue.push(adj);
+    ts.next_chunk = level_begin;
+    team.run([&](int thread_id) {
+        std::size_t first;
+        while ((first = ts.next_chunk.fetch_add(ts.chunk_size)) < level_end) {
+            std::size_t last = std::min(first + ts.chunk_size, level_end);
+            for (std::size_t i = first; i < last; i++)
+                for (int adj : graph[ts.order[i]])
+                    if (std::atomic_ref<int>(ts.in_deg[adj]).fetch_sub(1, std::memory_order_relaxed) == 1)
+                        ts.next[thread_id].push_back(adj);
         }
+    });
+    algorithm::_wts_gather(team, ts);
+}
+
+Schedule algorithm::wavefront_topological_sort (IntGraphView graph, int num_threads) {
+    if (!graph.is_directed()) 
+        throw std::invalid_argument("Graph is NOT directed!");
+
+    int num_vertices = graph.num_vertices();
+    parallel::Team team(num_threads);
+    algorithm::_wts_s ts = {
+        .in_deg = std::vector<int>(num_vertices),
+        .order = std::vector<int>(num_vertices),
+        .size = 0,
+        .next = std::vector<std::vector<int>>(team.size()),
+        .next_chunk = 0
+    };
+
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(num_vertices, thread_id, team.size());
+        for (std::size_t v = first; v < last; v++) {
+            ts.in_deg[v] = graph.in_deg(v);
+            if (!ts.in_deg[v])
+                ts.next[thread_id].push_back(v);
+        }
+    });
+    algorithm::_wts_gather(team, ts);
+
+    Schedule schedule;
+    std::size_t level_begin = 0;
+    while (level_begin < ts.size) {
+        std::size_t level_end = ts.size;
+        schedule.level_offsets.push_back(level_end);
+        GRAPH_FRONTIER(level_end - level_begin);
+        GRAPH_PHASE("level");
+        algorithm::_wts_level(graph, team, ts, level_begin, level_end);
+        level_begin = level_end;
     }
 
-    if (topological_order.size() != num_vertices) 
+    if (ts.size != std::size_t(num_vertices))
         throw std::invalid_argument("Graph is NOT acyclic!");
 
-    return topological_order;
+    schedule.order = std::move(ts.order);
+    return schedule;
 }
 
 
 // finding IntGraph's strongly connected componnents
-void algorithm::_scc_unit (IntGraph &graph, algorithm::_scc_s &cs, std::stack<int> &dfs_stack) {
-    // Tarjan's strongly connected components algorithm (iterative)
-    while (!dfs_stack.empty()) {
-        int v = dfs_stack.top();
-
-        if (!cs.on_stack[v]) {
-            cs.stack.push(v);
-            cs.on_stack[v] = true;
-        }
-
-        if (cs.componnent_index[v] == -1) 
-            cs.componnent_index[v] = cs.low_link[v] = cs.componnent++;
+template <typename Graph, typename Cursor>
+void algorithm::_scc_visit (const Graph &graph, algorithm::_scc_s <Cursor> &cs, int vertex) {
+    cs.rindex[vertex] = cs.index++;
+    cs.root[vertex] = true;
+    cs.dfs_stack.push_back(std::make_pair(vertex, graph[vertex].begin()));
+    GRAPH_COUNT(vertices_visited, 1);
+    GRAPH_HIGH_WATER(max_depth, cs.dfs_stack.size());
+}
 
-        for (int adj : graph[v]) {
-            if (cs.componnent_index[adj] == -1) {
-                dfs_stack.push(adj);
+template <typename Graph, typename Cursor>
+void algorithm::_scc_unit (const Graph &graph, algorithm::_scc_s <Cursor> &cs, int vertex) {
+    // every edge is examined once, or twice if it leads to a new vertex:
+    // the cursor stays on the edge so that it is finished when the search returns from it
+    algorithm::_scc_visit(graph, cs, vertex);
+    while (!cs.dfs_stack.empty()) {
+        auto [v, cursor] = cs.dfs_stack.back();
+        auto end = graph[v].end();
+
+        for (; cursor != end; ++cursor) {
+            GRAPH_COUNT(edges_scanned, 1);
+            int adj = *cursor;
+            if (cs.rindex[adj] == 0)
                 break;
+
+            if (cs.rindex[adj] < cs.rindex[v]) {
+                cs.rindex[v] = cs.rindex[adj];
+                cs.root[v] = false;
             }
-            else if (cs.on_stack[adj])
-                cs.low_link[v] = std::min(cs.low_link[v], cs.low_link[adj]);
         }
 
-        // If there are still vertices adjacent to v on the (dfs)stack 
-        if (dfs_stack.top()!= v) 
+        if (cursor != end) {
+            cs.dfs_stack.back().second = cursor;
+            algorithm::_scc_visit(graph, cs, *cursor);
             continue;
+        }
 
-        // if vertex is the root of a strongly connected componnent 
-        // push stacked vertices to the new_componnent (until vertex is found)
-        if (cs.low_link[v] == cs.componnent_index[v]) {
-            std::vector <int> new_componnent;
-            while (cs.on_stack[v]) {
-                int w = cs.stack.top();
-                cs.stack.pop();
-                cs.on_stack[w] = false;
-                new_componnent.push_back(w);
-            }
-            cs.scc.push_back(new_componnent);
+        cs.dfs_stack.pop_back();
+        if (!cs.root[v]) {
+            cs.stack.push_back(v);
+            continue;
         }
 
-        dfs_stack.pop();
+        // v is the root of a strongly connected componnent - 
+        // assign it and the stacked vertices visited after it
+        cs.index--;
+        while (!cs.stack.empty() && cs.rindex[v] <= cs.rindex[cs.stack.back()]) {
+            cs.rindex[cs.stack.back()] = cs.componnent;
+            cs.stack.pop_back();
+            cs.index--;
+        }
+        cs.rindex[v] = cs.componnent--;
     }
 }
 
-std::vector <std::vector <int>> algorithm::scc (IntGraph graph) {
+template <typename Graph>
+Components algorithm::_scc (const Graph &graph) {
+    using Cursor = decltype(graph[0].begin());
     int num_vertices = graph.num_vertices();
-    algorithm::_scc_s cs = {
-        .componnent_index = std::vector<int>(num_vertices, -1),
-        .low_link = std::vector<int>(num_vertices, -1),
-        .on_stack = std::vector<bool>(num_vertices, false),
-        .stack = std::stack<int>(), 
-        .componnent = 0,
-        .scc = std::vector<std::vector<int>>()
+    algorithm::_scc_s <Cursor> cs = {
+        .rindex = std::vector<int>(num_vertices, 0),
+        .root = std::vector<bool>(num_vertices, false),
+        .stack = std::vector<int>(),
+        .dfs_stack = std::vector<std::pair<int, Cursor>>(),
+        .index = 1,
+        .componnent = num_vertices
     };
 
-    std::stack <int> dfs_stack;
-
     for (int vertex = 0; vertex < num_vertices; vertex++) 
-        if (cs.componnent_index[vertex] == -1) {
-            dfs_stack.push(vertex);
-            algorithm::_scc_unit(graph, cs, dfs_stack);
+        if (cs.rindex[vertex] == 0)
+            algorithm::_scc_unit(graph, cs, vertex);
+
+    Components components;
+    components.num_components = num_vertices - cs.componnent;
+    components.component_idx = std::move(cs.rindex);
+    for (int &componnent : components.component_idx)
+        componnent = num_vertices - componnent;
+
+    return components;
+}
+
+Components algorithm::scc (IntGraphView graph) {
+    return algorithm::_scc(graph);
+}
+
+
+// finding IntGraph's strongly connected componnents in parallel
+void algorithm::_pscc_gather (parallel::Team &team, algorithm::_pscc_s &ps) {
+    std::vector <std::size_t> offsets(team.size() + 1, 0);
+    for (int thread_id = 0; thread_id < team.size(); thread_id++)
+        offsets[thread_id + 1] = offsets[thread_id] + ps.next[thread_id].size();
+
+    ps.frontier.resize(offsets.back());
+    team.run([&](int thread_id) {
+        std::copy(ps.next[thread_id].begin(), ps.next[thread_id].end(), ps.frontier.begin() + offsets[thread_id]);
+        ps.next[thread_id].clear();
+    });
+}
+
+template <typename Expand>
+void algorithm::_pscc_step (parallel::Team &team, algorithm::_pscc_s &ps, Expand expand) {
+    ps.next_chunk = 0;
+    team.run([&](int thread_id) {
+        std::size_t first;
+        while ((first = ps.next_chunk.fetch_add(ps.chunk_size)) < ps.frontier.size()) {
+            std::size_t last = std::min(first + ps.chunk_size, ps.frontier.size());
+            for (std::size_t i = first; i < last; i++)
+                expand(ps.frontier[i], ps.next[thread_id]);
+        }
+    });
+    algorithm::_pscc_gather(team, ps);
+}
+
+void algorithm::_pscc_trim (IntGraphView graph, parallel::Team &team, algorithm::_pscc_s &ps) {
+    // a vertex without active in- or out-neighbours is a componnent on its own
+    int num_vertices = graph.num_vertices();
+    std::vector <int> in_count(num_vertices), out_count(num_vertices);
+
+    auto claim = [&](int v) {
+        std::atomic_ref <int> component_idx(ps.component_idx[v]);
+        int expected = ps.unassigned;
+        if (!component_idx.compare_exchange_strong(expected, ps.unassigned - 1, std::memory_order_relaxed))
+            return false;
+        component_idx.store(ps.num_components.fetch_add(1), std::memory_order_relaxed);
+        return true;
+    };
+
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(num_vertices, thread_id, team.size());
+        for (std::size_t v = first; v < last; v++) {
+            in_count[v] = graph.in_deg(v);
+            out_count[v] = graph.out_deg(v);
+            if ((in_count[v] == 0 || out_count[v] == 0) && claim(v))
+                ps.next[thread_id].push_back(v);
         }
+    });
+    algorithm::_pscc_gather(team, ps);
+
+    while (!ps.frontier.empty())
+        algorithm::_pscc_step(team, ps, [&](int v, std::vector <int> &next) {
+            for (int adj : graph[v])
+                if (std::atomic_ref<int>(in_count[adj]).fetch_sub(1) == 1 && claim(adj))
+                    next.push_back(adj);
+            for (int adj : graph.adjacent_in(v))
+                if (std::atomic_ref<int>(out_count[adj]).fetch_sub(1) == 1 && claim(adj))
+                    next.push_back(adj);
+        });
+}
 
-    return cs.scc;
+void algorithm::_pscc_forward_backward (IntGraphView graph, parallel::Team &team, algorithm::_pscc_s &ps) {
+    // pivot: the unassigned vertex with the largest in_deg * out_deg
+    int num_vertices = graph.num_vertices();
+    std::vector <std::pair <long long, int>> best(team.size(), std::make_pair(-1LL, -1));
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(num_vertices, thread_id, team.size());
+        for (std::size_t v = first; v < last; v++)
+            if (ps.component_idx[v] == ps.unassigned)
+                best[thread_id] = std::max(best[thread_id], std::make_pair((long long)graph.in_deg(v) * graph.out_deg(v), (int)v));
+    });
+
+    int pivot = std::max_element(best.begin(), best.end())->second;
+    if (pivot == -1)
+        return;
+
+    // forward search over the unassigned vertices
+    ps.epoch++;
+    ps.mark[pivot] = ps.epoch;
+    ps.frontier.assign(1, pivot);
+    while (!ps.frontier.empty())
+        algorithm::_pscc_step(team, ps, [&](int v, std::vector <int> &next) {
+            for (int adj : graph[v]) {
+                std::atomic_ref <int> mark(ps.mark[adj]);
+                int current = mark.load(std::memory_order_relaxed);
+                if (current != ps.epoch && std::atomic_ref<int>(ps.component_idx[adj]).load(std::memory_order_relaxed) == ps.unassigned
+                    && mark.compare_exchange_strong(current, ps.epoch, std::memory_order_relaxed))
+                    next.push_back(adj);
+            }
+        });
+
+    // backward search over the forward reached vertices - their intersection is the pivot's componnent
+    int componnent = ps.num_components++;
+    ps.component_idx[pivot] = componnent;
+    ps.frontier.assign(1, pivot);
+    while (!ps.frontier.empty())
+        algorithm::_pscc_step(team, ps, [&](int v, std::vector <int> &next) {
+            for (int adj : graph.adjacent_in(v)) {
+                int expected = ps.unassigned;
+                if (std::atomic_ref<int>(ps.mark[adj]).load(std::memory_order_relaxed) == ps.epoch
+                    && std::atomic_ref<int>(ps.component_idx[adj]).compare_exchange_strong(expected, componnent, std::memory_order_relaxed))
+                    next.push_back(adj);
+            }
+        });
+}
+
+bool algorithm::_pscc_coloring (IntGraphView graph, parallel::Team &team, algorithm::_pscc_s &ps) {
+    // one colouring round - returns false if all the vertices were already assigned
+    // every vertex gets the colour of the largest vertex which reaches it; a vertex with its own colour
+    // is a root and its componnent are the vertices of its colour which reach it
+    int num_vertices = graph.num_vertices();
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(num_vertices, thread_id, team.size());
+        for (std::size_t v = first; v < last; v++)
+            if (ps.component_idx[v] == ps.unassigned) {
+                ps.color[v] = v;
+                ps.next[thread_id].push_back(v);
+            }
+    });
+    algorithm::_pscc_gather(team, ps);
+    if (ps.frontier.empty())
+        return false;
+
+    std::vector <int> active = ps.frontier;
+    while (!ps.frontier.empty()) {
+        ps.epoch++;
+        algorithm::_pscc_step(team, ps, [&](int v, std::vector <int> &next) {
+            int color = std::atomic_ref<int>(ps.color[v]).load(std::memory_order_relaxed);
+            for (int adj : graph[v]) {
+                if (std::atomic_ref<int>(ps.component_idx[adj]).load(std::memory_order_relaxed) != ps.unassigned)
+                    continue;
+
+                std::atomic_ref <int> adj_color(ps.color[adj]);
+                int current = adj_color.load(std::memory_order_relaxed);
+                bool raised = false;
+                while (color > current && !(raised = adj_color.compare_exchange_weak(current, color, std::memory_order_relaxed)));
+
+                std::atomic_ref <int> mark(ps.mark[adj]);
+                int adj_mark = mark.load(std::memory_order_relaxed);
+                if (raised && adj_mark != ps.epoch && mark.compare_exchange_strong(adj_mark, ps.epoch, std::memory_order_relaxed))
+                    next.push_back(adj);
+            }
+        });
+    }
+
+    ps.frontier.clear();
+    for (int v : active)
+        if (ps.color[v] == v) {
+            ps.component_idx[v] = ps.num_components++;
+            ps.frontier.push_back(v);
+        }
+
+    while (!ps.frontier.empty())
+        algorithm::_pscc_step(team, ps, [&](int v, std::vector <int> &next) {
+            for (int adj : graph.adjacent_in(v)) {
+                int expected = ps.unassigned;
+                if (ps.color[adj] == ps.color[v]
+                    && std::atomic_ref<int>(ps.component_idx[adj]).compare_exchange_strong(expected, ps.component_idx[v], std::memory_order_relaxed))
+                    next.push_back(adj);
+            }
+        });
+
+    return true;
+}
+
+Components algorithm::parallel_scc (IntGraphView graph, int num_threads) {
+    if (!graph.has_in_edges())
+        throw std::invalid_argument("Graph was frozen without in-edges!");
+
+    int num_vertices = graph.num_vertices();
+    parallel::Team team(num_threads);
+    algorithm::_pscc_s ps = {
+        .component_idx = std::vector<int>(num_vertices, algorithm::_pscc_s::unassigned),
+        .color = std::vector<int>(num_vertices, -1),
+        .mark = std::vector<int>(num_vertices, 0),
+        .epoch = 0,
+        .num_components = 0,
+        .frontier = std::vector<int>(),
+        .next = std::vector<std::vector<int>>(team.size()),
+        .next_chunk = 0
+    };
+
+    GRAPH_PHASE_BEGIN(trim, "trim");
+    algorithm::_pscc_trim(graph, team, ps);
+    GRAPH_PHASE_END(trim);
+    GRAPH_PHASE_BEGIN(forward_backward, "forward-backward");
+    algorithm::_pscc_forward_backward(graph, team, ps);
+    GRAPH_PHASE_END(forward_backward);
+    GRAPH_PHASE_BEGIN(coloring, "coloring");
+    while (algorithm::_pscc_coloring(graph, team, ps));
+    GRAPH_PHASE_END(coloring);
+
+    Components components;
+    components.num_components = ps.num_components;
+    components.component_idx = std::move(ps.component_idx);
+    return components;
 }
 
 
 // checking if a IntGraph is bipartite
-std::pair<std::vector <int>, std::vector <int>> algorithm::bipartite_partition (IntGraph graph) {
+bool algorithm::_bipartite_s::on_edge (int v, int adj) {
+    if (this->colors[adj] == this->colors[v])
+        throw std::invalid_argument("Graph is NOT bipartite!");
+
+    if (this->colors[adj] != gray)
+        return false;
+
+    this->colors[adj] = -this->colors[v];
+    return true;
+}
+
+template <typename Graph>
+std::pair<std::vector <int>, std::vector <int>> algorithm::_bipartite_partition (const Graph &graph) {
     // O(|V| + |E|) time complexity
-    const int gray = 0; // not yet visited
-    const int red = 1;
+    const int gray = _bipartite_s::gray;
+    const int red = _bipartite_s::red;
 
     int num_vertices = graph.num_vertices();
-    std::vector <int> colors(num_vertices, gray); // 0: gray, 1: red, -1: blue
-    std::queue <int> queue;
-    
+    algorithm::_bipartite_s bs = {.colors = std::vector<int>(num_vertices, gray)};
+    Queue queue;
+
     for (int vertex = 0; vertex < num_vertices; vertex++) {
-        if (colors[vertex] == gray) {
-            colors[vertex] = red;
+        if (bs.colors[vertex] == gray) {
+            bs.colors[vertex] = red;
             queue.push(vertex);
-            
-            while (!queue.empty()) {
-                int v = queue.front();
-                queue.pop();
-
-                for (int adj : graph[v]) {
-                    if (colors[adj] == colors[v])
-                        throw std::invalid_argument("Graph is NOT bipartite!");
-                    
-                    if (colors[adj] == gray) {
-                        colors[adj] = -colors[v];
-                        queue.push(adj);
-                    }
-                }
-            }
+            algorithm::traverse(graph, queue, bs);
         }
     }
 
     std::vector <int> red_vertices, blue_vertices;
     for (int v = 0; v < num_vertices; v++) {
-        if (colors[v] == red)
+        if (bs.colors[v] == red)
             red_vertices.push_back(v);
         else 
             blue_vertices.push_back(v);
     }
 
     return std::make_pair(red_vertices, blue_vertices);
-}
\ No newline at end of file
+}
+
+std::pair<std::vector <int>, std::vector <int>> algorithm::bipartite_partition (IntGraphView graph) {
+    return algorithm::_bipartite_partition(graph);
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+
+
+
+
+// Instrumentation of the algorithms - compiled in with -DGRAPH_INSTRUMENT
+// Without it the GRAPH_* hooks expand to nothing and the algorithms are unchanged
+// The hooks:
+//   GRAPH_COUNT(counter, n) - adds n to a counter of the calling thread (instrument::Counters)
+//   GRAPH_HIGH_WATER(counter, value) - raises a counter of the calling thread to value
+//   GRAPH_FRONTIER(size) - appends the size of a bfs / wavefront level (coordinating thread only)
+//   GRAPH_PHASE(name) - times the enclosing scope
+//   GRAPH_PHASE_BEGIN(id, name) / GRAPH_PHASE_END(id) - times a span of a scope (ended by the scope at the latest)
+#ifdef GRAPH_INSTRUMENT
+#define GRAPH_CONCAT_(a, b) a##b
+#define GRAPH_CONCAT(a, b) GRAPH_CONCAT_(a, b)
+#define GRAPH_COUNT(counter, n) (instrument::local().counter += (n))
+#define GRAPH_HIGH_WATER(counter, value) (instrument::local().counter = std::max<std::uint64_t>(instrument::local().counter, (value)))
+#define GRAPH_FRONTIER(size) instrument::recorder().frontier(size)
+#define GRAPH_PHASE(name) instrument::Phase GRAPH_CONCAT(_graph_phase_, __LINE__)(name)
+#define GRAPH_PHASE_BEGIN(id, name) instrument::Phase _graph_phase_##id(name)
+#define GRAPH_PHASE_END(id) _graph_phase_##id.stop()
+#else
+#define GRAPH_COUNT(counter, n) ((void)0)
+#define GRAPH_HIGH_WATER(counter, value) ((void)0)
+#define GRAPH_FRONTIER(size) ((void)0)
+#define GRAPH_PHASE(name) ((void)0)
+#define GRAPH_PHASE_BEGIN(id, name) ((void)0)
+#define GRAPH_PHASE_END(id) ((void)0)
+#endif
+
+
+
+// Declarations
+namespace instrument {
+    // `_` prefixed members should be considered private
+
+    #ifdef GRAPH_INSTRUMENT
+    constexpr bool enabled = true;
+    #else
+    constexpr bool enabled = false;
+    #endif
+
+    struct Counters {
+        std::uint64_t edges_scanned = 0;
+        std::uint64_t vertices_visited = 0;
+        std::uint64_t max_depth = 0; // stack / queue / dfs stack high-water mark
+
+        void merge (const Counters &other);
+    };
+
+    struct _event_s {
+        // a complete trace event ("ph": "X") or a counter sample ("ph": "C")
+        std::string name;
+        char type;
+        double begin; // [us] since the recorder was created
+        double duration; // [us] - X only
+        std::uint64_t value; // C only
+        int thread;
+    };
+
+    struct _thread_s {
+        // counters of one thread - merged into the recorder when the thread exits
+        Counters counters;
+        int id;
+
+        _thread_s();
+        ~_thread_s();
+    };
+
+    _thread_s& _thread_state(); // thread_local
+
+    class Recorder {
+        // Process-wide sink of the instrumentation - phases, frontiers and the counters of every thread
+        private:
+            std::mutex mutex;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector <_event_s> events;
+            std::vector <std::uint64_t> frontiers;
+            std::vector <_thread_s*> threads; // the threads alive
+            Counters finished; // the threads which exited
+            int next_thread = 0;
+
+            friend struct _thread_s;
+
+        public:
+            double now() const; // [us]
+            void frontier (std::uint64_t size);
+            void event (std::string name, double begin, double duration);
+
+            Counters counters();
+            void write_trace (std::string file_name); // Chrome trace-event JSON (chrome://tracing, Perfetto)
+            void show_summary (std::ostream &out = std::cout);
+    };
+
+    Recorder& recorder();
+    Counters& local(); // the counters of the calling thread
+
+    class Phase {
+        // times its scope, or until stop()
+        private:
+            std::string name;
+            double begin;
+            bool stopped = false;
+
+        public:
+            Phase (std::string name);
+            ~Phase();
+
+            void stop();
+    };
+}
+
+// Definitions
+// Counters
+void instrument::Counters::merge (const Counters &other) {
+    this->edges_scanned += other.edges_scanned;
+    this->vertices_visited += other.vertices_visited;
+    this->max_depth = std::max(this->max_depth, other.max_depth);
+}
+
+
+// thread state
+instrument::_thread_s::_thread_s () {
+    Recorder &r = instrument::recorder();
+    std::lock_guard <std::mutex> lock(r.mutex);
+    this->id = r.next_thread++;
+    r.threads.push_back(this);
+}
+
+instrument::_thread_s::~_thread_s () {
+    Recorder &r = instrument::recorder();
+    std::lock_guard <std::mutex> lock(r.mutex);
+    r.finished.merge(this->counters);
+    r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+}
+
+instrument::_thread_s& instrument::_thread_state () {
+    thread_local instrument::_thread_s state;
+    return state;
+}
+
+
+// Recorder
+double instrument::Recorder::now () const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this->start).count();
+}
+
+void instrument::Recorder::frontier (std::uint64_t size) {
+    int thread = _thread_state().id;
+    std::lock_guard <std::mutex> lock(this->mutex);
+    this->frontiers.push_back(size);
+    this->events.push_back(_event_s{.name = "frontier", .type = 'C', .begin = this->now(), .duration = 0, .value = size, .thread = thread});
+}
+
+void instrument::Recorder::event (std::string name, double begin, double duration) {
+    int thread = _thread_state().id;
+    std::lock_guard <std::mutex> lock(this->mutex);
+    this->events.push_back(_event_s{.name = std::move(name), .type = 'X', .begin = begin, .duration = duration, .value = 0, .thread = thread});
+}
+
+instrument::Counters instrument::Recorder::counters () {
+    std::lock_guard <std::mutex> lock(this->mutex);
+    Counters total = this->finished;
+    for (_thread_s *thread : this->threads)
+        total.merge(thread->counters);
+    return total;
+}
+
+void instrument::Recorder::write_trace (std::string file_name) {
+    Counters total = this->counters();
+    std::lock_guard <std::mutex> lock(this->mutex);
+    std::ofstream out(file_name);
+    if (!out)
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    char buffer[256];
+    out << "{\"traceEvents\": [\n";
+    for (std::size_t i = 0; i < this->events.size(); i++) {
+        const _event_s &e = this->events[i];
+        if (e.type == 'X')
+            std::snprintf(buffer, sizeof(buffer), "{\"name\": \"%s\", \"cat\": \"graph\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+                          e.name.c_str(), e.begin, e.duration, e.thread);
+        else
+            std::snprintf(buffer, sizeof(buffer), "{\"name\": \"%s\", \"cat\": \"graph\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d, \"args\": {\"vertices\": %llu}}",
+                          e.name.c_str(), e.begin, e.thread, (unsigned long long)e.value);
+        out << buffer << (i + 1 < this->events.size() ? ",\n" : "\n");
+    }
+    out << "],\n\"otherData\": {\"edges_scanned\": " << total.edges_scanned
+        << ", \"vertices_visited\": " << total.vertices_visited
+        << ", \"max_depth\": " << total.max_depth << "}}\n";
+}
+
+void instrument::Recorder::show_summary (std::ostream &out) {
+    Counters total = this->counters();
+    std::lock_guard <std::mutex> lock(this->mutex);
+
+    // phases by name in the order of their first end - nested phases are included in their parents
+    std::vector <std::pair <std::string, std::pair <int, double>>> phases; // (name, (count, total [us]))
+    for (const _event_s &e : this->events) {
+        if (e.type != 'X')
+            continue;
+        auto it = std::find_if(phases.begin(), phases.end(), [&](const auto &phase) { return phase.first == e.name; });
+        if (it == phases.end())
+            it = phases.insert(phases.end(), std::make_pair(e.name, std::make_pair(0, 0.0)));
+        it->second.first++;
+        it->second.second += e.duration;
+    }
+
+    char buffer[256];
+    out << "\nInstrumentation summary:\n";
+    std::snprintf(buffer, sizeof(buffer), "%-20s %8s %12s\n", "phase", "count", "time [ms]");
+    out << buffer;
+    for (const auto &[name, stats] : phases) {
+        std::snprintf(buffer, sizeof(buffer), "%-20s %8d %12.3f\n", name.c_str(), stats.first, stats.second / 1000);
+        out << buffer;
+    }
+
+    out << "\nEdges scanned: " << total.edges_scanned << "\n";
+    out << "Vertices visited: " << total.vertices_visited << "\n";
+    out << "Max depth: " << total.max_depth << "\n";
+    if (!this->frontiers.empty()) {
+        out << "Levels: " << this->frontiers.size() << ", max frontier: "
+            << *std::max_element(this->frontiers.begin(), this->frontiers.end()) << "\n";
+        if (this->frontiers.size() <= 50) {
+            out << "Frontiers: ";
+            for (std::uint64_t size : this->frontiers)
+                out << size << " ";
+            out << "\n";
+        }
+    }
+}
+
+instrument::Recorder& instrument::recorder () {
+    static Recorder r;
+    return r;
+}
+
+instrument::Counters& instrument::local () {
+    return _thread_state().counters;
+}
+
+
+// Phase
+instrument::Phase::Phase (std::string name) {
+    this->name = std::move(name);
+    this->begin = instrument::recorder().now();
+}
+
+instrument::Phase::~Phase () {
+    this->stop();
+}
+
+void instrument::Phase::stop () {
+    if (this->stopped)
+        return;
+
+    this->stopped = true;
+    Recorder &r = instrument::recorder();
+    r.event(this->name, this->begin, r.now() - this->begin);
+}
@@ -1,26 +1,230 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <filesystem>
+#include <unistd.h>
 #include "graph.hpp"
+#include "union_find.hpp"
+#include "snapshot.hpp"
+#include "semi_external.hpp"
+#include "generators.hpp"
+#include "distributed.hpp"
+#include "instrument.hpp"
 
 
 
 
 
+// usage: ./main <algorithm> <graph file | generator> [snapshot file | memory edges | workers [socket|shm]] [--summary] [--trace=<json file>] [--verify]
+// generator: "model:scale[:edge factor[:D|U[:seed]]]" - the graph is generated in memory (see generators.hpp),
+//            for the streamed sbi, edfs and escc into a temporary text file
+// --summary, --trace: counters and phase times of a build with -DGRAPH_INSTRUMENT
+// --verify: a snapshot is opened with the O(n + m) checksum and structure checks (see snapshot.hpp)
+struct Options {
+    std::vector <std::string> arguments; // positional
+    bool summary = false;
+    bool verify = false;
+    std::string trace_file;
+};
+
+Options parse_options (int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--summary")
+            options.summary = true;
+        else if (argument == "--verify")
+            options.verify = true;
+        else if (argument.starts_with("--trace="))
+            options.trace_file = argument.substr(8);
+        else
+            options.arguments.push_back(argument);
+    }
+    return options;
+}
+
+void report_instrumentation (const Options &options) {
+    if (!options.summary && options.trace_file.empty())
+        return;
+
+    if (!instrument::enabled) {
+        std::cout << "\nInstrumentation is compiled out - build with -DGRAPH_INSTRUMENT\n";
+        return;
+    }
+
+    if (options.summary)
+        instrument::recorder().show_summary();
+    if (!options.trace_file.empty()) {
+        instrument::recorder().write_trace(options.trace_file);
+        std::cout << "\nTrace saved: " << options.trace_file << "\n";
+    }
+}
+
+
+// a generated graph file of the streamed algorithms - removed at the exit (also by std::exit)
+struct TemporaryFile {
+    std::string name;
+
+    ~TemporaryFile() {
+        std::error_code error;
+        if (!this->name.empty())
+            std::filesystem::remove(this->name, error);
+    }
+};
+
+
+
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
+    Options options = parse_options(argc, argv);
+    if (options.arguments.size() < 2) {
         printf("Error: Invalid arguments\n");
         return 1;
     }
 
-    std::string algorithm = argv[1];
-    std::string file_name = argv[2];
+    std::string algorithm = options.arguments[0];
+    std::string file_name = options.arguments[1];
+
+    // the streamed algorithms read the edges from a file - a generator spec is written to a temporary one
+    static TemporaryFile generated;
+    std::string stream_file = file_name;
+    if ((algorithm == "sbi" || algorithm == "edfs" || algorithm == "escc") && graph::is_generator_spec(file_name)) {
+        try {
+            std::cout << "Generating data...\n";
+            generated.name = std::filesystem::temp_directory_path() / ("graph_" + std::to_string(getpid()) + ".txt");
+            graph::GraphGenerator(graph::generator_from_string(file_name)).write(generated.name);
+            stream_file = generated.name;
+        }
+        catch (std::exception& e) {
+            std::cout << "Error: Could not generate '" << file_name << "'!\n\t";
+            std::cout << e.what() << "\n";
+            std::exit(1);
+        }
+    }
+
+    // exercise 4 - streamed: the graph is never stored, only the union-find over its vertices (undirected graphs only)
+    if (algorithm == "sbi") {
+        try {
+            auto start = std::chrono::high_resolution_clock::now();
+            GRAPH_PHASE_BEGIN(compute, "compute");
+            graph::ParityUnionFind uf = graph::algorithm::stream_components(stream_file);
+            GRAPH_PHASE_END(compute);
+            auto stop = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            GRAPH_PHASE("output");
+
+            std::cout << "\nConnected componnents: " << uf.num_components() << "\n";
+            std::cout << "\nBipartite graph:\n";
+            if (!uf.is_bipartite())
+                std::cout << "Graph is NOT bipartite!\n";
+            else if (uf.num_vertices() <= 200) {
+                std::pair<std::vector <int>, std::vector <int>> bp = uf.bipartite_partition();
+                std::cout << "Red: ";
+                for (int v : bp.first)
+                    std::cout << v << " ";
+                std::cout << "\nBlue: ";
+                for (int v : bp.second)
+                    std::cout << v << " ";
+                std::cout << "\n";
+            }
+            else
+                std::cout << "Graph is bipartite!\n";
+            std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+        }
+        catch (std::exception& e) {
+            std::cout << "Error: Could not read '" << file_name << "'!\n\t";
+            std::cout << e.what() << "\n";
+            std::exit(1);
+        }
+        report_instrumentation(options);
+        return 0;
+    }
+
+    // semi-external: only the per-vertex arrays are stored, the edges are read from the file in passes
+    if (algorithm == "edfs" || algorithm == "escc") {
+        try {
+            std::size_t memory_edges = options.arguments.size() > 2 ? std::stoull(options.arguments[2]) : 0;
+            graph::EdgeStream edges(stream_file);
+            auto start = std::chrono::high_resolution_clock::now();
+            GRAPH_PHASE_BEGIN(compute, "compute");
+            graph::SearchResult search;
+            graph::Components scc;
+            if (algorithm == "edfs")
+                search = graph::algorithm::external_dfs(edges, false, memory_edges);
+            else
+                scc = graph::algorithm::external_scc(edges, memory_edges);
+            GRAPH_PHASE_END(compute);
+            auto stop = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            GRAPH_PHASE("output");
+
+            if (algorithm == "edfs") {
+                std::cout << "\nDFS vertex visiting order:\n";
+                for (int v : search.order)
+                    std::cout << v + 1 << " ";
+                std::cout << "\n\nDFS search tree:\n";
+                if (edges.num_vertices() <= 200)
+                    search.tree().show();
+                else
+                    std::cout << "Roots: " << search.num_roots() << "\n";
+            }
+            else {
+                std::cout << "\nStrongly connected componnents:\n";
+                std::cout << "Number of SCCs: " << scc.num_components << "\n";
+                if (edges.num_vertices() <= 200) {
+                    scc.group();
+                    for (int c = 0; c < scc.num_components; c++) {
+                        std::cout << c + 1 << ": ";
+                        for (int v : scc[c])
+                            std::cout << v + 1 << " ";
+                        std::cout << "\n";
+                    }
+                }
+            }
+
+            const graph::ExternalStats &stats = edges.stats();
+            std::cout << "Passes: " << stats.passes << ", batches: " << stats.batches << "\n";
+            std::cout << "Read: " << (double)stats.bytes_read / (1 << 20) << " MiB, " << stats.edges_read << " edges\n";
+            std::cout << "Resident: " << (double)stats.resident_bytes / (1 << 20) << " MiB\n";
+            std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+        }
+        catch (std::exception& e) {
+            std::cout << "Error: Could not read '" << file_name << "'!\n\t";
+            std::cout << e.what() << "\n";
+            std::exit(1);
+        }
+        report_instrumentation(options);
+        return 0;
+    }
 
+    // the bottom-up steps of dobfs and the backward searches of pscc scan the in-edges (reverse CSR)
+    // snapshots are always saved with them
+    bool with_in_edges = algorithm == "dobfs" || algorithm == "pscc" || algorithm == "snapshot";
+
+    // a text edge list is parsed into `graph` (or generated), a binary snapshot is mapped - the algorithms use `view`
     graph::IntGraph graph;
+    graph::GraphSnapshot snapshot;
+    graph::IntGraphView view;
+    GRAPH_PHASE_BEGIN(load, "load");
     try {
-        graph.from_file(file_name);
-        if (graph.num_vertices() <= 20)
-            graph.show();
+        if (graph::is_generator_spec(file_name)) {
+            std::cout << "Generating data...\n";
+            graph = graph::GraphGenerator(graph::generator_from_string(file_name)).graph(graph::BuildOptions{.with_in_edges = with_in_edges});
+            view = graph;
+        }
+        else if (graph::GraphSnapshot::is_snapshot(file_name)) {
+            snapshot = graph::GraphSnapshot(file_name, options.verify);
+            view = snapshot.view();
+        }
+        else {
+            graph.from_file(file_name, with_in_edges);
+            view = graph;
+        }
+
+        if (with_in_edges && !view.has_reverse_csr())
+            throw std::invalid_argument("Error: The snapshot was saved without in-edges");
+        GRAPH_PHASE_END(load);
+        if (view.num_vertices() <= 20)
+            view.show();
     }
     catch (std::invalid_argument& e) {
         std::cout << "Error: Could not read '" << file_name << "'!\n\t";
@@ -33,33 +237,138 @@ int main(int argc, char* argv[]) {
         std::exit(1);
     }
 
+    // binary snapshot of the graph for the next runs
+    if (algorithm == "snapshot") {
+        if (options.arguments.size() < 3) {
+            printf("Error: Invalid arguments - the snapshot file name is missing\n");
+            return 1;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::GraphSnapshot::save(view, options.arguments[2]);
+        GRAPH_PHASE_END(compute);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
+
+        std::cout << "\nSnapshot saved: " << options.arguments[2] << "\n";
+        std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+    }
+
     // exercise 1
-    if (algorithm == "dfs") {
+    else if (algorithm == "dfs") {
         auto start = std::chrono::high_resolution_clock::now();
-        std::pair <std::vector <int>, IntGraph> search = graph::algorithm::search(graph, true);
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::SearchResult search = graph::algorithm::search(view, true);
+        GRAPH_PHASE_END(compute);
         auto stop = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
         
         std::cout << "\nDFS vertex visiting order:\n";
-        for (int v : search.first) 
+        for (int v : search.order) 
             std::cout << v + 1 << " ";
 
         std::cout << "\n\nDFS search tree:\n";
-        search.second.show();
+        if (view.num_vertices() <= 200)
+            search.tree().show();
+        else
+            std::cout << "Roots: " << search.num_roots() << "\n";
         std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
     }
     else if (algorithm == "bfs") {
         auto start = std::chrono::high_resolution_clock::now();
-        std::pair <std::vector <int>, IntGraph> search = graph::algorithm::search(graph, false);
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::SearchResult search = graph::algorithm::search(view, false);
+        GRAPH_PHASE_END(compute);
         auto stop = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
         
         std::cout << "\nBFS vertex visiting order:\n";
-        for (int v : search.first) 
+        for (int v : search.order) 
             std::cout << v + 1 << " ";
 
         std::cout << "\n\nBFS search tree:\n";
-        search.second.show();
+        if (view.num_vertices() <= 200)
+            search.tree().show();
+        else
+            std::cout << "Roots: " << search.num_roots() << "\n";
+        std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+    }
+    else if (algorithm == "pbfs") {
+        auto start = std::chrono::high_resolution_clock::now();
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::SearchResult search = graph::algorithm::parallel_bfs(view);
+        GRAPH_PHASE_END(compute);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
+        
+        std::cout << "\nBFS vertex visiting order:\n";
+        for (int v : search.order) 
+            std::cout << v + 1 << " ";
+
+        std::cout << "\n\nBFS search tree:\n";
+        if (view.num_vertices() <= 200)
+            search.tree().show();
+        else
+            std::cout << "Roots: " << search.num_roots() << "\n";
+        std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+    }
+    else if (algorithm == "dbfs") {
+        int num_workers = options.arguments.size() > 2 ? std::stoi(options.arguments[2]) : 4;
+        std::string transport = options.arguments.size() > 3 ? options.arguments[3] : "socket";
+        if (transport != "socket" && transport != "shm") {
+            std::cout << "Error: Invalid value of `transport` - must be ['socket', 'shm']!\n";
+            return 1;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::DistributedResult result = transport == "socket"
+            ? graph::algorithm::distributed_bfs<graph::SocketTransport>(view, num_workers)
+            : graph::algorithm::distributed_bfs<graph::SharedMemoryTransport>(view, num_workers);
+        GRAPH_PHASE_END(compute);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
+
+        std::cout << "\nBFS vertex visiting order:\n";
+        for (int v : result.search.order)
+            std::cout << v + 1 << " ";
+
+        std::cout << "\n\nBFS search tree:\n";
+        if (view.num_vertices() <= 200)
+            result.search.tree().show();
+        else
+            std::cout << "Roots: " << result.search.num_roots() << "\n";
+
+        std::cout << "\nWorkers: " << num_workers << " (" << transport << "), rounds: " << result.rounds << "\n";
+        printf("%-8s %12s %14s %14s\n", "level", "frontier", "messages", "bytes");
+        for (std::size_t level = 0; level < result.levels.size(); level++)
+            printf("%-8zu %12zu %14zu %14zu\n", level, result.levels[level].frontier, result.levels[level].messages, result.levels[level].bytes);
+        std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+    }
+    else if (algorithm == "dobfs") {
+        auto start = std::chrono::high_resolution_clock::now();
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::SearchResult search = graph::algorithm::direction_optimizing_bfs(view);
+        GRAPH_PHASE_END(compute);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
+        
+        std::cout << "\nBFS vertex visiting order:\n";
+        for (int v : search.order) 
+            std::cout << v + 1 << " ";
+
+        std::cout << "\n\nBFS search tree:\n";
+        if (view.num_vertices() <= 200)
+            search.tree().show();
+        else
+            std::cout << "Roots: " << search.num_roots() << "\n";
         std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
     }
 
@@ -68,11 +377,14 @@ int main(int argc, char* argv[]) {
         std::cout << "\nTopological order:\n";
         try {
             auto start = std::chrono::high_resolution_clock::now();
-            std::vector <int> topological_order = graph::algorithm::topological_sort(graph);
+            GRAPH_PHASE_BEGIN(compute, "compute");
+            std::vector <int> topological_order = graph::algorithm::topological_sort(view);
+            GRAPH_PHASE_END(compute);
             auto stop = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            GRAPH_PHASE("output");
 
-            if (graph.num_vertices() <= 200) {
+            if (view.num_vertices() <= 200) {
                 for (int v : topological_order)
                     std::cout << v + 1 << " ";
                 std::cout << "\n";
@@ -87,20 +399,50 @@ int main(int argc, char* argv[]) {
 
     }
 
+    else if (algorithm == "wts") {
+        std::cout << "\nTopological order levels:\n";
+        try {
+            auto start = std::chrono::high_resolution_clock::now();
+            GRAPH_PHASE_BEGIN(compute, "compute");
+            graph::Schedule schedule = graph::algorithm::wavefront_topological_sort(view);
+            GRAPH_PHASE_END(compute);
+            auto stop = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            GRAPH_PHASE("output");
+
+            std::cout << "Number of levels: " << schedule.num_levels() << "\n";
+            if (view.num_vertices() <= 200) {
+                for (int l = 0; l < schedule.num_levels(); l++) {
+                    std::cout << l + 1 << ": ";
+                    for (int v : schedule[l])
+                        std::cout << v + 1 << " ";
+                    std::cout << "\n";
+                }
+            }
+            std::cout << "Execution time: " << (float)duration.count() / 1000 << "s\n";
+        }
+        catch (std::invalid_argument &e) {
+            std::cout << e.what() << "\n";
+        }
+    }
+
     // exercise 3
-    else if (algorithm == "scc") {
+    else if (algorithm == "scc" || algorithm == "pscc") {
         std::cout << "\nStrongly connected componnents:\n";
         auto start = std::chrono::high_resolution_clock::now();
-        std::vector <std::vector <int>> scc = graph::algorithm::scc(graph);
+        GRAPH_PHASE_BEGIN(compute, "compute");
+        graph::Components scc = algorithm == "scc" ? graph::algorithm::scc(view) : graph::algorithm::parallel_scc(view);
+        GRAPH_PHASE_END(compute);
         auto stop = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        GRAPH_PHASE("output");
 
-        std::cout << "Number of SCCs: " << scc.size() << "\n";
-        if (graph.num_vertices() <= 200) {
-            int index = 0;
-            for (std::vector <int> componnent : scc) {
-                std::cout << ++index << ": ";
-                for (int v : componnent)
+        std::cout << "Number of SCCs: " << scc.num_components << "\n";
+        if (view.num_vertices() <= 200) {
+            scc.group();
+            for (int c = 0; c < scc.num_components; c++) {
+                std::cout << c + 1 << ": ";
+                for (int v : scc[c])
                     std::cout << v + 1 << " ";
                 std::cout << "\n";
             }
@@ -113,11 +455,14 @@ int main(int argc, char* argv[]) {
         std::cout << "\nBipartite graph:\n";
         try {
             auto start = std::chrono::high_resolution_clock::now();
-            std::pair<std::vector <int>, std::vector <int>> bp = graph::algorithm::bipartite_partition(graph); 
+            GRAPH_PHASE_BEGIN(compute, "compute");
+            std::pair<std::vector <int>, std::vector <int>> bp = graph::algorithm::bipartite_partition(view); 
+            GRAPH_PHASE_END(compute);
             auto stop = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            GRAPH_PHASE("output");
 
-            if (graph.num_vertices() <= 200) {
+            if (view.num_vertices() <= 200) {
                 std::cout << "Red: ";
                 for (int v : bp.first)
                     std::cout << v << " ";
@@ -135,8 +480,9 @@ int main(int argc, char* argv[]) {
         }
     }
     else {
-        std::cout << "Error: Invalid value of `algorithm` - must be ['dfs', 'bfs', 'to', 'scc', 'bi']!\n";
+        std::cout << "Error: Invalid value of `algorithm` - must be ['dfs', 'bfs', 'dobfs', 'pbfs', 'dbfs', 'to', 'wts', 'scc', 'pscc', 'bi', 'sbi', 'edfs', 'escc', 'snapshot']!\n";
     }
     
+    report_instrumentation(options);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+
+
+// Declarations
+namespace graph {
+    class MappedFile {
+        // Read-only memory mapping of a whole file (POSIX)
+        // The pages are loaded by the kernel on first access, so the parsing threads
+        // read the file directly from the page cache - without a copy through a stream buffer
+        private:
+            std::span <const char> bytes;
+
+            void unmap();
+
+        public:
+            MappedFile() = default;
+            MappedFile (std::string file_name);
+            MappedFile (const MappedFile&) = delete;
+            MappedFile& operator = (const MappedFile&) = delete;
+            MappedFile (MappedFile &&other);
+            MappedFile& operator = (MappedFile &&other);
+            ~MappedFile();
+
+            std::size_t size() const;
+            std::span <const char> data() const;
+    };
+}
+
+// Definitions
+using namespace graph;
+
+MappedFile::MappedFile (std::string file_name) {
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    struct stat status;
+    if (::fstat(fd, &status) < 0) {
+        ::close(fd);
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+    }
+
+    std::size_t size = status.st_size;
+    if (size > 0) {
+        void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::invalid_argument("Could not map: " + file_name + "!");
+        }
+
+        ::madvise(address, size, MADV_SEQUENTIAL);
+        this->bytes = std::span<const char>(static_cast<const char*>(address), size);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+MappedFile::MappedFile (MappedFile &&other) {
+    std::swap(this->bytes, other.bytes);
+}
+
+MappedFile& MappedFile::operator= (MappedFile &&other) {
+    if (this != &other) {
+        this->unmap();
+        std::swap(this->bytes, other.bytes);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    this->unmap();
+}
+
+void MappedFile::unmap () {
+    if (!this->bytes.empty())
+        ::munmap(const_cast<char*>(this->bytes.data()), this->bytes.size());
+    this->bytes = std::span<const char>();
+}
+
+std::size_t MappedFile::size () const {
+    return this->bytes.size();
+}
+
+std::span <const char> MappedFile::data () const {
+    return this->bytes;
+}
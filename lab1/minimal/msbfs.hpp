@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <span>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include "graph.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    struct MultiSourceDistances {
+        // hop distances from every source (-1: unreachable)
+        // distances from sources[i]: values[i * num_vertices .. (i + 1) * num_vertices)
+        int num_vertices = 0;
+        std::vector <int> sources;
+        std::vector <int> values;
+
+        std::span <const int> operator [] (int source_idx) const;
+    };
+
+    struct SourceStats {
+        // aggregated distances from one source - O(1) memory per source
+        int source;
+        int reached = 0; // including the source
+        long long distance_sum = 0;
+        int eccentricity = 0; // largest finite distance
+
+        double closeness() const; // (reached - 1) / distance_sum - 0 for isolated sources
+    };
+
+
+
+    namespace algorithm {
+        // `_` prefixed members should be considered private
+
+        // bit-parallel multi-source bfs (MS-BFS, Then et al.)
+        // Every batch of 64 * Words sources is searched at once: each vertex keeps a bitset
+        // (one bit per source) of the searches which have seen it and which have it in their frontier,
+        // so a single scan of an adjacency list advances all the searches of the batch
+        // The bitsets are fixed-width word arrays combined with OR / AND-NOT loops, which the
+        // compiler turns into SIMD instructions (Words = 4: 256-bit vectors)
+        // It pays off on small-world graphs, where the searches share most of their levels -
+        // on deep graphs (long paths) the sources reach a vertex on different levels and share little
+        template <int Words>
+        struct _msbfs_s {
+            // structures required for the multi-source bfs - num_vertices * Words words each
+            std::vector <std::uint64_t> seen;
+            std::vector <std::uint64_t> frontier;
+            std::vector <std::uint64_t> next;
+            // the vertices with non-empty bitsets - deep graphs do not scan all the vertices on every level
+            static constexpr int dense_ratio = 16; // a frontier is dense above num_vertices / dense_ratio vertices
+            std::vector <int> frontier_vertices = {};
+            std::vector <int> next_vertices = {};
+        };
+
+        // visit(vertex, level, lane) is called once for every vertex reached by the search of batch[lane]
+        template <int Words, typename Visitor>
+        void _msbfs_batch (IntGraphView graph, _msbfs_s<Words> &ms, std::span <const int> batch, Visitor visit);
+
+        // hop distances from a single source - the reference for the multi-source searches
+        std::vector <int> bfs_distances (IntGraphView graph, int source);
+
+        template <int Words = 1>
+        MultiSourceDistances multi_source_bfs (IntGraphView graph, std::span <const int> sources);
+
+        template <int Words = 1>
+        std::vector <SourceStats> multi_source_bfs_stats (IntGraphView graph, std::span <const int> sources);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// MultiSourceDistances
+std::span <const int> MultiSourceDistances::operator[] (int source_idx) const {
+    return std::span<const int>(this->values).subspan(std::size_t(source_idx) * this->num_vertices, this->num_vertices);
+}
+
+
+// SourceStats
+double SourceStats::closeness () const {
+    if (this->distance_sum == 0)
+        return 0;
+    return double(this->reached - 1) / this->distance_sum;
+}
+
+
+// multi-source bfs
+template <int Words, typename Visitor>
+void algorithm::_msbfs_batch (IntGraphView graph, algorithm::_msbfs_s<Words> &ms, std::span <const int> batch, Visitor visit) {
+    int num_vertices = graph.num_vertices();
+    std::fill(ms.seen.begin(), ms.seen.end(), 0);
+    // frontier and next are left empty by the previous batch
+
+    ms.frontier_vertices.clear();
+    for (int lane = 0; lane < (int)batch.size(); lane++) {
+        int source = batch[lane];
+        if (source < 0 || source >= num_vertices)
+            throw std::invalid_argument("Error: Invalid source (" + std::to_string(source) + ")");
+
+        std::uint64_t *frontier = ms.frontier.data() + std::size_t(source) * Words;
+        if (std::all_of(frontier, frontier + Words, [](std::uint64_t word) { return word == 0; }))
+            ms.frontier_vertices.push_back(source);
+
+        std::uint64_t bit = std::uint64_t(1) << (lane % 64);
+        ms.seen[std::size_t(source) * Words + lane / 64] |= bit;
+        frontier[lane / 64] |= bit;
+        visit(source, 0, lane);
+    }
+
+    for (int level = 1; !ms.frontier_vertices.empty(); level++) {
+        // a large frontier reaches a large part of the graph - the next level is then
+        // gathered by a sequential scan of all the vertices instead of a list of the touched ones
+        bool dense = ms.frontier_vertices.size() > std::size_t(num_vertices / algorithm::_msbfs_s<Words>::dense_ratio);
+
+        // top-down step shared by all the searches: next[adj] |= frontier[v]
+        ms.next_vertices.clear();
+        for (int v : ms.frontier_vertices) {
+            const std::uint64_t *frontier = ms.frontier.data() + std::size_t(v) * Words;
+            for (int adj : graph[v]) {
+                std::uint64_t *next = ms.next.data() + std::size_t(adj) * Words;
+                std::uint64_t touched = 0;
+                for (int w = 0; w < Words; w++) {
+                    touched |= next[w];
+                    next[w] |= frontier[w];
+                }
+                if (!dense && !touched)
+                    ms.next_vertices.push_back(adj);
+            }
+        }
+
+        for (int v : ms.frontier_vertices)
+            std::fill_n(ms.frontier.data() + std::size_t(v) * Words, Words, 0);
+        ms.frontier_vertices.clear();
+
+        // the new frontier: next AND-NOT seen
+        auto advance = [&](int v) {
+            std::uint64_t *next = ms.next.data() + std::size_t(v) * Words;
+            std::uint64_t *seen = ms.seen.data() + std::size_t(v) * Words;
+            std::uint64_t *frontier = ms.frontier.data() + std::size_t(v) * Words;
+            std::uint64_t discovered = 0;
+            for (int w = 0; w < Words; w++) {
+                frontier[w] = next[w] & ~seen[w];
+                seen[w] |= frontier[w];
+                next[w] = 0;
+                discovered |= frontier[w];
+            }
+            if (!discovered)
+                return;
+
+            ms.frontier_vertices.push_back(v);
+            for (int w = 0; w < Words; w++)
+                for (std::uint64_t bits = frontier[w]; bits; bits &= bits - 1)
+                    visit(v, level, w * 64 + std::countr_zero(bits));
+        };
+
+        if (dense)
+            for (int v = 0; v < num_vertices; v++)
+                advance(v);
+        else
+            for (int v : ms.next_vertices)
+                advance(v);
+    }
+}
+
+std::vector <int> algorithm::bfs_distances (IntGraphView graph, int source) {
+    int num_vertices = graph.num_vertices();
+    if (source < 0 || source >= num_vertices)
+        throw std::invalid_argument("Error: Invalid source (" + std::to_string(source) + ")");
+
+    std::vector <int> distances(num_vertices, -1);
+    std::vector <int> queue;
+    queue.reserve(num_vertices);
+    distances[source] = 0;
+    queue.push_back(source);
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        int v = queue[head];
+        for (int adj : graph[v])
+            if (distances[adj] == -1) {
+                distances[adj] = distances[v] + 1;
+                queue.push_back(adj);
+            }
+    }
+
+    return distances;
+}
+
+template <int Words>
+MultiSourceDistances algorithm::multi_source_bfs (IntGraphView graph, std::span <const int> sources) {
+    constexpr std::size_t batch_size = 64 * Words;
+    int num_vertices = graph.num_vertices();
+    MultiSourceDistances distances = {
+        .num_vertices = num_vertices,
+        .sources = std::vector<int>(sources.begin(), sources.end()),
+        .values = std::vector<int>(sources.size() * num_vertices, -1)
+    };
+
+    algorithm::_msbfs_s<Words> ms = {
+        .seen = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words),
+        .frontier = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words),
+        .next = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words)
+    };
+
+    for (std::size_t first = 0; first < sources.size(); first += batch_size) {
+        std::span <const int> batch = sources.subspan(first, std::min(batch_size, sources.size() - first));
+        algorithm::_msbfs_batch<Words>(graph, ms, batch, [&](int v, int level, int lane) {
+            distances.values[(first + lane) * num_vertices + v] = level;
+        });
+    }
+
+    return distances;
+}
+
+template <int Words>
+std::vector <SourceStats> algorithm::multi_source_bfs_stats (IntGraphView graph, std::span <const int> sources) {
+    constexpr std::size_t batch_size = 64 * Words;
+    int num_vertices = graph.num_vertices();
+    std::vector <SourceStats> stats(sources.size());
+    for (std::size_t i = 0; i < sources.size(); i++)
+        stats[i].source = sources[i];
+
+    algorithm::_msbfs_s<Words> ms = {
+        .seen = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words),
+        .frontier = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words),
+        .next = std::vector<std::uint64_t>(std::size_t(num_vertices) * Words)
+    };
+
+    for (std::size_t first = 0; first < sources.size(); first += batch_size) {
+        std::span <const int> batch = sources.subspan(first, std::min(batch_size, sources.size() - first));
+        algorithm::_msbfs_batch<Words>(graph, ms, batch, [&](int, int level, int lane) {
+            SourceStats &source = stats[first + lane];
+            source.reached++;
+            source.distance_sum += level;
+            source.eccentricity = level; // the levels are visited in ascending order
+        });
+    }
+
+    return stats;
+}
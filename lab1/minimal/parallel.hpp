@@ -0,0 +1,204 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+#include <utility>
+
+
+
+
+
+// Declarations
+namespace graph {
+    namespace parallel {
+        // Team of threads kept alive between the parallel steps of an algorithm,
+        // so that level-synchronous algorithms do not spawn threads on every level
+        class Team {
+            private:
+                int num_threads;
+                std::vector <std::thread> workers;
+                std::mutex mutex;
+                std::condition_variable start_cv;
+                std::condition_variable done_cv;
+                std::function <void(int)> task;
+                std::size_t generation = 0;
+                int running = 0;
+                bool stopping = false;
+                std::exception_ptr error; // the first exception thrown by a task of the current run
+
+                void work (int thread_id);
+
+            public:
+                Team (int num_threads = 0); // 0: one thread per hardware thread
+                Team (const Team&) = delete;
+                Team& operator = (const Team&) = delete;
+                ~Team();
+
+                int size() const;
+                // runs task(thread_id) on every thread of the team - the caller is thread 0
+                // Returns once all the threads finished, then rethrows the first exception of a task
+                void run (std::function <void(int)> task);
+        };
+
+        // [begin, end) part of the `size` elements assigned to `thread_id` by a static partition
+        std::pair <std::size_t, std::size_t> chunk (std::size_t size, int thread_id, int num_threads);
+
+        // chunks sorted by the threads and merged pairwise
+        template <typename It, typename Compare = std::less<>>
+        void sort (Team &team, It begin, It end, Compare compare = Compare());
+
+        // in-place inclusive prefix sum: chunk sums, their sequential scan, chunk offsets added by the threads
+        template <typename It>
+        void partial_sum (Team &team, It begin, It end);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// Team
+parallel::Team::Team (int num_threads) {
+    if (num_threads <= 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    this->num_threads = num_threads;
+    for (int thread_id = 1; thread_id < num_threads; thread_id++)
+        this->workers.emplace_back(&parallel::Team::work, this, thread_id);
+}
+
+parallel::Team::~Team() {
+    {
+        std::lock_guard <std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->start_cv.notify_all();
+    for (std::thread &worker : this->workers)
+        worker.join();
+}
+
+int parallel::Team::size () const {
+    return this->num_threads;
+}
+
+void parallel::Team::work (int thread_id) {
+    std::size_t generation = 0;
+    while (true) {
+        std::unique_lock <std::mutex> lock(this->mutex);
+        this->start_cv.wait(lock, [&] { return this->stopping || this->generation != generation; });
+        if (this->stopping)
+            return;
+
+        generation = this->generation;
+        lock.unlock();
+        try {
+            this->task(thread_id);
+        }
+        catch (...) {
+            lock.lock();
+            if (!this->error)
+                this->error = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+
+        if (--this->running == 0)
+            this->done_cv.notify_one();
+    }
+}
+
+void parallel::Team::run (std::function <void(int)> task) {
+    {
+        std::lock_guard <std::mutex> lock(this->mutex);
+        this->task = std::move(task);
+        this->running = this->num_threads - 1;
+        this->generation++;
+    }
+    this->start_cv.notify_all();
+
+    std::exception_ptr error;
+    try {
+        this->task(0);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // the workers use the task and the state of the caller - they are awaited even if thread 0 threw
+    std::unique_lock <std::mutex> lock(this->mutex);
+    this->done_cv.wait(lock, [&] { return this->running == 0; });
+    if (!error)
+        error = this->error;
+    this->error = nullptr;
+    lock.unlock();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+
+// utils
+std::pair <std::size_t, std::size_t> parallel::chunk (std::size_t size, int thread_id, int num_threads) {
+    return std::make_pair(size * thread_id / num_threads, size * (thread_id + 1) / num_threads);
+}
+
+template <typename It, typename Compare>
+void parallel::sort (parallel::Team &team, It begin, It end, Compare compare) {
+    std::size_t size = end - begin;
+    int num_chunks = team.size();
+    if (num_chunks == 1 || size < 4096) {
+        std::sort(begin, end, compare);
+        return;
+    }
+
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(size, thread_id, num_chunks);
+        std::sort(begin + first, begin + last, compare);
+    });
+
+    // merge rounds: chunks [i, i + width) and [i + width, i + 2 * width)
+    for (int width = 1; width < num_chunks; width *= 2)
+        team.run([&](int thread_id) {
+            int left = thread_id * 2 * width;
+            if (left + width >= num_chunks)
+                return;
+
+            std::size_t first = parallel::chunk(size, left, num_chunks).first;
+            std::size_t middle = parallel::chunk(size, left + width, num_chunks).first;
+            std::size_t last = parallel::chunk(size, std::min(left + 2 * width, num_chunks) - 1, num_chunks).second;
+            std::inplace_merge(begin + first, begin + middle, begin + last, compare);
+        });
+}
+
+template <typename It>
+void parallel::partial_sum (parallel::Team &team, It begin, It end) {
+    std::size_t size = end - begin;
+    int num_chunks = team.size();
+    if (num_chunks == 1 || size < 4096) {
+        std::partial_sum(begin, end, begin);
+        return;
+    }
+
+    using value_type = typename std::iterator_traits<It>::value_type;
+    std::vector <value_type> chunk_sums(num_chunks + 1, value_type());
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(size, thread_id, num_chunks);
+        std::partial_sum(begin + first, begin + last, begin + first);
+        if (first < last)
+            chunk_sums[thread_id + 1] = *(begin + last - 1);
+    });
+
+    std::partial_sum(chunk_sums.begin(), chunk_sums.end(), chunk_sums.begin());
+    team.run([&](int thread_id) {
+        auto [first, last] = parallel::chunk(size, thread_id, num_chunks);
+        for (std::size_t i = first; i < last; i++)
+            *(begin + i) += chunk_sums[thread_id];
+    });
+}
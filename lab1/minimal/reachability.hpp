@@ -0,0 +1,262 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <span>
+#include <utility>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+#include "graph.hpp"
+#include "parallel.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    struct _reach_s {
+        // workspace of the pruned dfs of one query (one per thread)
+        std::vector <std::uint32_t> stamp; // component -> query which visited it
+        std::uint32_t query = 0;
+        std::vector <int> stack;
+    };
+
+
+
+    class ReachabilityIndex {
+        // "Can u reach v?" queries against a fixed graph
+        // The strongly connected components are contracted into the condensation DAG, which gets
+        // its topological order and GRAIL interval labels (Yildirim et al.): every one of the
+        // `num_labels` randomized dfs traversals labels a component with [lowest post-order
+        // reachable from it, its own post-order]. If u reaches v, every label of v lies inside
+        // the label of u, so a non-contained label (or a later topological position) is an exact
+        // negative answer. The post-order range of the dfs subtree of u is an exact positive answer
+        // for its tree descendants; the remaining queries run a dfs pruned by the same conditions
+        // Memory: 4 + 4 * (1 + 3 * num_labels) bytes per vertex / component plus the condensation
+        private:
+            std::vector <int> component_idx;
+            IntGraph condensation;
+            std::vector <int> topological_position; // component -> position in the topological order
+            int num_labels;
+            // component c, traversal i: [low, first, post] = labels[3 * (c * num_labels + i) ..]
+            // first: the lowest post-order in the dfs subtree of c
+            std::vector <int> labels;
+            _reach_s workspace;
+
+            bool contains (int u, int v) const; // components - every label of v inside the label of u
+            bool can_reach (int u, int v) const; // components - the label and the topological filters
+            bool descends (int u, int v) const; // components - v in the dfs subtree of u in some traversal
+            bool reaches (int u, int v, _reach_s &rs) const; // components
+
+        public:
+            ReachabilityIndex (IntGraphView graph, int num_labels = 3, unsigned seed = 1);
+            ~ReachabilityIndex() = default;
+
+            int num_vertices() const;
+            int num_components() const;
+            std::size_t num_condensation_edges() const;
+
+            bool reaches (int u, int v);
+            // answers[i] = 1 if queries[i].first reaches queries[i].second - answered by all the threads of a team
+            std::vector <std::uint8_t> reaches (std::span <const std::pair <int, int>> queries, int num_threads = 0) const;
+    };
+}
+
+// Definitions
+using namespace graph;
+
+ReachabilityIndex::ReachabilityIndex (IntGraphView graph, int num_labels, unsigned seed) {
+    if (num_labels < 1)
+        throw std::invalid_argument("Error: At least one label is required");
+
+    // condensation DAG without duplicated edges
+    Components scc = algorithm::scc(graph);
+    this->component_idx = std::move(scc.component_idx);
+    int num_components = scc.num_components;
+    int num_vertices = graph.num_vertices();
+
+    std::vector <std::size_t> out_offsets(num_components + 1, 0);
+    for (int v = 0; v < num_vertices; v++)
+        for (int adj : graph[v])
+            if (this->component_idx[v] != this->component_idx[adj])
+                out_offsets[this->component_idx[v] + 1]++;
+    std::partial_sum(out_offsets.begin(), out_offsets.end(), out_offsets.begin());
+
+    std::vector <int> out_targets(out_offsets.back());
+    std::vector <std::size_t> cursor(out_offsets.begin(), out_offsets.end() - 1);
+    for (int v = 0; v < num_vertices; v++)
+        for (int adj : graph[v])
+            if (this->component_idx[v] != this->component_idx[adj])
+                out_targets[cursor[this->component_idx[v]]++] = this->component_idx[adj];
+
+    // in place: the deduplicated list of c is moved to the end of the list of c - 1
+    std::size_t size = 0;
+    for (int c = 0; c < num_components; c++) {
+        auto first = out_targets.begin() + out_offsets[c];
+        auto last = out_targets.begin() + out_offsets[c + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        out_offsets[c] = size;
+        for (auto it = first; it != last; it++)
+            out_targets[size++] = *it;
+    }
+    out_offsets[num_components] = size;
+    out_targets.resize(size);
+    this->condensation.from_csr(true, std::move(out_offsets), std::move(out_targets));
+
+    std::vector <int> topological_order = algorithm::topological_sort(this->condensation);
+    this->topological_position.resize(num_components);
+    for (int i = 0; i < num_components; i++)
+        this->topological_position[topological_order[i]] = i;
+
+    // GRAIL labels: randomized post-order dfs traversals from the sources of the DAG
+    this->num_labels = num_labels;
+    this->labels.assign(3 * std::size_t(num_components) * num_labels, 0);
+    std::mt19937 random(seed);
+    std::vector <int> roots;
+    for (int c = 0; c < num_components; c++)
+        if (this->condensation.in_deg(c) == 0)
+            roots.push_back(c);
+
+    std::vector <bool> visited(num_components);
+    std::vector <std::pair <int, int>> dfs_stack; // (component, children left)
+    std::vector <int> rotation(num_components); // the first child of a component in this traversal
+    for (int i = 0; i < num_labels; i++) {
+        std::shuffle(roots.begin(), roots.end(), random);
+        for (int c = 0; c < num_components; c++)
+            rotation[c] = this->condensation.out_deg(c) > 0 ? random() % this->condensation.out_deg(c) : 0;
+        std::fill(visited.begin(), visited.end(), false);
+
+        int post = 0;
+        auto low = [&](int c) -> int& { return this->labels[3 * (std::size_t(c) * num_labels + i)]; };
+        auto first = [&](int c) -> int& { return this->labels[3 * (std::size_t(c) * num_labels + i) + 1]; };
+        auto high = [&](int c) -> int& { return this->labels[3 * (std::size_t(c) * num_labels + i) + 2]; };
+        for (int root : roots) {
+            visited[root] = true;
+            low(root) = INT_MAX;
+            first(root) = post;
+            dfs_stack.push_back(std::make_pair(root, this->condensation.out_deg(root)));
+            while (!dfs_stack.empty()) {
+                auto &[c, children_left] = dfs_stack.back();
+                if (children_left == 0) {
+                    high(c) = post++;
+                    low(c) = std::min(low(c), high(c));
+                    int finished = c;
+                    dfs_stack.pop_back();
+                    if (!dfs_stack.empty())
+                        low(dfs_stack.back().first) = std::min(low(dfs_stack.back().first), low(finished));
+                    continue;
+                }
+
+                std::span <const int> children = this->condensation[c];
+                int child = children[(rotation[c] + --children_left) % children.size()];
+                if (!visited[child]) {
+                    visited[child] = true;
+                    low(child) = INT_MAX;
+                    first(child) = post;
+                    dfs_stack.push_back(std::make_pair(child, this->condensation.out_deg(child)));
+                }
+                else
+                    low(c) = std::min(low(c), low(child));
+            }
+        }
+    }
+
+    this->workspace.stamp.assign(num_components, 0);
+}
+
+int ReachabilityIndex::num_vertices () const {
+    return this->component_idx.size();
+}
+
+int ReachabilityIndex::num_components () const {
+    return this->condensation.num_vertices();
+}
+
+std::size_t ReachabilityIndex::num_condensation_edges () const {
+    return this->condensation.num_edges();
+}
+
+bool ReachabilityIndex::contains (int u, int v) const {
+    const int *u_labels = this->labels.data() + 3 * std::size_t(u) * this->num_labels;
+    const int *v_labels = this->labels.data() + 3 * std::size_t(v) * this->num_labels;
+    for (int i = 0; i < 3 * this->num_labels; i += 3)
+        if (v_labels[i] < u_labels[i] || v_labels[i + 2] > u_labels[i + 2])
+            return false;
+    return true;
+}
+
+bool ReachabilityIndex::descends (int u, int v) const {
+    const int *u_labels = this->labels.data() + 3 * std::size_t(u) * this->num_labels;
+    const int *v_labels = this->labels.data() + 3 * std::size_t(v) * this->num_labels;
+    for (int i = 0; i < 3 * this->num_labels; i += 3)
+        if (u_labels[i + 1] <= v_labels[i + 2] && v_labels[i + 2] <= u_labels[i + 2])
+            return true;
+    return false;
+}
+
+bool ReachabilityIndex::can_reach (int u, int v) const {
+    return this->topological_position[u] <= this->topological_position[v] && this->contains(u, v);
+}
+
+bool ReachabilityIndex::reaches (int u, int v, _reach_s &rs) const {
+    if (u == v)
+        return true;
+    if (!this->can_reach(u, v))
+        return false;
+    if (this->descends(u, v))
+        return true;
+
+    // pruned dfs: only the components which still may reach v
+    if (++rs.query == 0) {
+        std::fill(rs.stamp.begin(), rs.stamp.end(), 0);
+        rs.query = 1;
+    }
+
+    rs.stack.assign(1, u);
+    rs.stamp[u] = rs.query;
+    while (!rs.stack.empty()) {
+        int c = rs.stack.back();
+        rs.stack.pop_back();
+        for (int child : this->condensation[c]) {
+            if (child == v || this->descends(child, v))
+                return true;
+            if (rs.stamp[child] != rs.query && this->can_reach(child, v)) {
+                rs.stamp[child] = rs.query;
+                rs.stack.push_back(child);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool ReachabilityIndex::reaches (int u, int v) {
+    if (u < 0 || u >= this->num_vertices() || v < 0 || v >= this->num_vertices())
+        throw std::invalid_argument("Error: Invalid query (" + std::to_string(u) + "," + std::to_string(v) + ")");
+    return this->reaches(this->component_idx[u], this->component_idx[v], this->workspace);
+}
+
+std::vector <std::uint8_t> ReachabilityIndex::reaches (std::span <const std::pair <int, int>> queries, int num_threads) const {
+    for (auto [u, v] : queries)
+        if (u < 0 || u >= this->num_vertices() || v < 0 || v >= this->num_vertices())
+            throw std::invalid_argument("Error: Invalid query (" + std::to_string(u) + "," + std::to_string(v) + ")");
+
+    std::vector <std::uint8_t> answers(queries.size());
+    parallel::Team team(num_threads);
+    std::vector <_reach_s> workspaces(team.size());
+    team.run([&](int thread_id) {
+        _reach_s &rs = workspaces[thread_id];
+        rs.stamp.assign(this->num_components(), 0);
+        auto [first, last] = parallel::chunk(queries.size(), thread_id, team.size());
+        for (std::size_t i = first; i < last; i++)
+            answers[i] = this->reaches(this->component_idx[queries[i].first], this->component_idx[queries[i].second], rs);
+    });
+
+    return answers;
+}
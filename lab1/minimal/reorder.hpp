@@ -0,0 +1,335 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <queue>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include "graph.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    struct Permutation {
+        // relabeling of the vertices: the vertex v of the original graph
+        // is new_id[v] in the reordered graph and old_id is the inverse mapping
+        std::vector <int> new_id;
+        std::vector <int> old_id;
+
+        Permutation() = default;
+        Permutation (std::vector <int> order); // order[i]: original vertex which becomes i
+        ~Permutation() = default;
+
+        int size() const;
+        Permutation inverse() const;
+        // reordered ids -> original ids (e.g. a search order)
+        std::vector <int> original_vertices (std::span <const int> vertices) const;
+        // values indexed by the reordered ids -> values indexed by the original ids (e.g. component indices)
+        template <typename T>
+        std::vector <T> original_values (std::span <const T> values) const;
+    };
+
+
+
+    enum class Ordering {
+        bfs, // breadth-first order - neighbours get close ids
+        rcm, // reverse Cuthill-McKee - small bandwidth of the adjacency matrix
+        degree, // descending degree - the hubs share the cache lines
+        gorder // greedy windowed neighbour overlap (Wei et al.)
+    };
+
+    Ordering ordering_from_string (std::string name);
+
+
+
+    namespace algorithm {
+        // `_` prefixed members should be considered private
+
+        // The orderings treat the graph as undirected: the in-edges of a directed graph
+        // are used if it was frozen with them, otherwise only the out-edges
+        std::vector <int> _degrees (IntGraphView graph);
+        std::vector <int> _bfs_order (IntGraphView graph);
+        std::vector <int> _rcm_order (IntGraphView graph);
+        std::vector <int> _degree_order (IntGraphView graph);
+
+        struct _gorder_s {
+            // structures required for the gorder heuristic
+            static constexpr int window = 5; // the last placed vertices scored against
+            static constexpr int sibling_limit = 16; // larger in-neighbours do not make their out-neighbours siblings
+
+            int hub_limit; // sqrt(|V|) - hubs in the window do not score their neighbours
+
+            std::vector <int> score; // neighbours and siblings in the window
+            std::vector <bool> placed;
+            std::priority_queue <std::pair <int, int>> heap; // (score, vertex) - lazily updated
+        };
+
+        void _gorder_update (IntGraphView graph, _gorder_s &gs, int vertex, int delta);
+        std::vector <int> _gorder_order (IntGraphView graph);
+
+        Permutation reorder_permutation (IntGraphView graph, Ordering ordering);
+        // the relabeled graph - the adjacency lists are sorted by the new ids
+        IntGraph reorder (IntGraphView graph, const Permutation &permutation, bool with_in_edges = false);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// Permutation
+Permutation::Permutation (std::vector <int> order) {
+    this->old_id = std::move(order);
+    this->new_id.assign(this->old_id.size(), -1);
+    for (int i = 0; i < (int)this->old_id.size(); i++) {
+        int v = this->old_id[i];
+        if (v < 0 || v >= (int)this->old_id.size() || this->new_id[v] != -1)
+            throw std::invalid_argument("Error: The order is not a permutation");
+        this->new_id[v] = i;
+    }
+}
+
+int Permutation::size () const {
+    return this->old_id.size();
+}
+
+Permutation Permutation::inverse () const {
+    return Permutation(this->new_id);
+}
+
+std::vector <int> Permutation::original_vertices (std::span <const int> vertices) const {
+    std::vector <int> original(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); i++)
+        original[i] = this->old_id[vertices[i]];
+    return original;
+}
+
+template <typename T>
+std::vector <T> Permutation::original_values (std::span <const T> values) const {
+    std::vector <T> original(values.size());
+    for (std::size_t v = 0; v < values.size(); v++)
+        original[v] = values[this->new_id[v]];
+    return original;
+}
+
+
+Ordering graph::ordering_from_string (std::string name) {
+    if (name == "bfs")
+        return Ordering::bfs;
+    if (name == "rcm")
+        return Ordering::rcm;
+    if (name == "degree")
+        return Ordering::degree;
+    if (name == "gorder")
+        return Ordering::gorder;
+    throw std::invalid_argument("Invalid ordering (" + name + ") - must be ['bfs', 'rcm', 'degree', 'gorder']");
+}
+
+
+
+// orderings
+std::vector <int> algorithm::_degrees (IntGraphView graph) {
+    int num_vertices = graph.num_vertices();
+    bool with_in_edges = graph.is_directed() && graph.has_in_edges();
+    std::vector <int> degrees(num_vertices);
+    for (int v = 0; v < num_vertices; v++)
+        degrees[v] = graph.out_deg(v) + (with_in_edges ? graph.in_deg(v) : 0);
+    return degrees;
+}
+
+std::vector <int> algorithm::_bfs_order (IntGraphView graph) {
+    // every component is searched from its smallest vertex
+    int num_vertices = graph.num_vertices();
+    bool with_in_edges = graph.is_directed() && graph.has_in_edges();
+    std::vector <bool> visited(num_vertices, false);
+    std::vector <int> order;
+    order.reserve(num_vertices);
+
+    for (int s = 0; s < num_vertices; s++) {
+        if (visited[s])
+            continue;
+
+        visited[s] = true;
+        order.push_back(s);
+        for (std::size_t head = order.size() - 1; head < order.size(); head++) {
+            int v = order[head];
+            for (std::span <const int> adjacent : {graph[v], with_in_edges ? graph.adjacent_in(v) : std::span<const int>()})
+                for (int adj : adjacent)
+                    if (!visited[adj]) {
+                        visited[adj] = true;
+                        order.push_back(adj);
+                    }
+        }
+    }
+
+    return order;
+}
+
+std::vector <int> algorithm::_rcm_order (IntGraphView graph) {
+    // Cuthill-McKee: bfs from a minimal degree vertex of every component,
+    // the neighbours of a vertex are visited by ascending degree - the order is reversed at the end
+    int num_vertices = graph.num_vertices();
+    bool with_in_edges = graph.is_directed() && graph.has_in_edges();
+    std::vector <int> degrees = algorithm::_degrees(graph);
+    auto by_degree = [&](int u, int v) { return degrees[u] < degrees[v] || (degrees[u] == degrees[v] && u < v); };
+
+    std::vector <int> seeds(num_vertices);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::sort(seeds.begin(), seeds.end(), by_degree);
+
+    std::vector <bool> visited(num_vertices, false);
+    std::vector <int> order;
+    order.reserve(num_vertices);
+
+    for (int s : seeds) {
+        if (visited[s])
+            continue;
+
+        visited[s] = true;
+        order.push_back(s);
+        for (std::size_t head = order.size() - 1; head < order.size(); head++) {
+            int v = order[head];
+            std::size_t discovered = order.size();
+            for (std::span <const int> adjacent : {graph[v], with_in_edges ? graph.adjacent_in(v) : std::span<const int>()})
+                for (int adj : adjacent)
+                    if (!visited[adj]) {
+                        visited[adj] = true;
+                        order.push_back(adj);
+                    }
+            std::sort(order.begin() + discovered, order.end(), by_degree);
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector <int> algorithm::_degree_order (IntGraphView graph) {
+    std::vector <int> degrees = algorithm::_degrees(graph);
+    std::vector <int> order(graph.num_vertices());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int u, int v) { return degrees[u] > degrees[v]; });
+    return order;
+}
+
+void algorithm::_gorder_update (IntGraphView graph, _gorder_s &gs, int vertex, int delta) {
+    // `vertex` enters (delta = 1) or leaves (delta = -1) the window:
+    // the score of its unplaced neighbours and siblings (common in-neighbour) changes
+    bool with_in_edges = graph.has_in_edges();
+    auto change = [&](int v) {
+        if (gs.placed[v])
+            return;
+        gs.score[v] += delta;
+        if (delta > 0)
+            gs.heap.push(std::make_pair(gs.score[v], v));
+    };
+
+    if (graph.out_deg(vertex) > gs.hub_limit)
+        return;
+
+    for (int adj : graph[vertex])
+        change(adj);
+
+    if (!with_in_edges || graph.in_deg(vertex) > gs.hub_limit)
+        return;
+
+    for (int parent : graph.adjacent_in(vertex)) {
+        if (graph.is_directed())
+            change(parent);
+        if (graph.out_deg(parent) > _gorder_s::sibling_limit)
+            continue;
+        for (int sibling : graph[parent])
+            if (sibling != vertex)
+                change(sibling);
+    }
+}
+
+std::vector <int> algorithm::_gorder_order (IntGraphView graph) {
+    // The next vertex is the one with the most neighbours and siblings among the last `window`
+    // placed vertices. A decreased score is not pushed - its stale (higher) heap entry
+    // is re-pushed with the current score when it reaches the top
+    // Vertices without any score are taken by descending degree
+    int num_vertices = graph.num_vertices();
+    _gorder_s gs;
+    gs.score.assign(num_vertices, 0);
+    gs.placed.assign(num_vertices, false);
+    gs.hub_limit = std::max(_gorder_s::sibling_limit, (int)std::sqrt(num_vertices));
+
+    std::vector <int> seeds = algorithm::_degree_order(graph);
+    std::size_t next_seed = 0;
+    std::vector <int> order;
+    order.reserve(num_vertices);
+
+    while ((int)order.size() < num_vertices) {
+        int vertex = -1;
+        while (!gs.heap.empty() && vertex == -1) {
+            auto [score, v] = gs.heap.top();
+            gs.heap.pop();
+            if (gs.placed[v])
+                continue;
+
+            if (score != gs.score[v]) {
+                if (gs.score[v] > 0)
+                    gs.heap.push(std::make_pair(gs.score[v], v));
+                continue;
+            }
+            vertex = v;
+        }
+
+        if (vertex == -1) {
+            while (gs.placed[seeds[next_seed]])
+                next_seed++;
+            vertex = seeds[next_seed];
+        }
+
+        gs.placed[vertex] = true;
+        order.push_back(vertex);
+        algorithm::_gorder_update(graph, gs, vertex, 1);
+        if ((int)order.size() > _gorder_s::window)
+            algorithm::_gorder_update(graph, gs, order[order.size() - 1 - _gorder_s::window], -1);
+    }
+
+    return order;
+}
+
+Permutation algorithm::reorder_permutation (IntGraphView graph, Ordering ordering) {
+    switch (ordering) {
+        case Ordering::bfs:
+            return Permutation(algorithm::_bfs_order(graph));
+        case Ordering::rcm:
+            return Permutation(algorithm::_rcm_order(graph));
+        case Ordering::degree:
+            return Permutation(algorithm::_degree_order(graph));
+        case Ordering::gorder:
+            return Permutation(algorithm::_gorder_order(graph));
+    }
+    throw std::invalid_argument("Invalid ordering");
+}
+
+IntGraph algorithm::reorder (IntGraphView graph, const Permutation &permutation, bool with_in_edges) {
+    int num_vertices = graph.num_vertices();
+    if (permutation.size() != num_vertices)
+        throw std::invalid_argument("Error: The permutation does not match the graph");
+
+    std::vector <std::size_t> out_offsets(num_vertices + 1, 0);
+    for (int v = 0; v < num_vertices; v++)
+        out_offsets[v + 1] = out_offsets[v] + graph.out_deg(permutation.old_id[v]);
+
+    std::vector <int> out_targets(out_offsets.back());
+    for (int v = 0; v < num_vertices; v++) {
+        std::size_t cursor = out_offsets[v];
+        for (int adj : graph[permutation.old_id[v]])
+            out_targets[cursor++] = permutation.new_id[adj];
+        std::sort(out_targets.begin() + out_offsets[v], out_targets.begin() + cursor);
+    }
+
+    IntGraph reordered;
+    reordered.from_csr(graph.is_directed(), std::move(out_offsets), std::move(out_targets), with_in_edges);
+    return reordered;
+}
@@ -0,0 +1,506 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "graph.hpp"
+#include "snapshot.hpp"
+#include "instrument.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    // `_` prefixed members should be considered private
+
+    struct ExternalStats {
+        // cost of a semi-external run - for sizing the memory and the disk bandwidth
+        int passes = 0; // sequential reads of the edge section
+        std::uint64_t bytes_read = 0;
+        std::uint64_t edges_read = 0;
+        std::uint64_t batches = 0; // in-memory restructurings of the dfs forest
+        std::size_t resident_bytes = 0; // the per-vertex arrays and the edge buffer
+    };
+
+
+
+    class EdgeStream {
+        // Sequential reader of the edges of a graph file - a text edge list or a binary snapshot
+        // Only the header (and the offsets of a snapshot - O(|V|)) stay in memory: every pass
+        // reads the edge section from the disk again in blocks of `block_size` bytes
+        // The edges of undirected text files are produced in both directions (as a snapshot stores them)
+        private:
+            std::string file_name;
+            bool snapshot = false;
+            bool directed = false;
+            int n_vertices = 0;
+            std::uint64_t n_edges = 0; // edge list lines / snapshot entries
+            std::uint64_t edges_offset = 0; // of the edge section in the file
+            std::vector <std::uint64_t> offsets; // snapshot only
+            ExternalStats counters;
+
+            template <typename Consumer>
+            void _pass_text (std::ifstream &infile, Consumer &emit);
+            template <typename Consumer>
+            void _pass_snapshot (std::ifstream &infile, Consumer &emit);
+
+        public:
+            static constexpr std::size_t block_size = 1 << 20;
+
+            EdgeStream (std::string file_name);
+            ~EdgeStream() = default;
+
+            bool is_directed() const;
+            int num_vertices() const;
+            const ExternalStats& stats() const;
+            void _account (std::uint64_t batches, std::size_t resident_bytes);
+
+            // one sequential pass: consume(u, v) for every edge u -> v, or v -> u if `reverse`
+            template <typename Consumer>
+            void pass (bool reverse, Consumer consume);
+    };
+
+
+
+    namespace algorithm {
+        // Semi-external dfs (EM-DFS, Sibeyn et al.): only O(|V|) words and a buffer of `memory_edges`
+        // edges are resident (0: 4 |V| edges). The dfs forest T is kept in memory and every buffer B
+        // of streamed edges is merged into it as a dfs of T + B which scans the children in T before
+        // the edges of B. An edge u -> v with v after the subtree of u in the preorder violates T -
+        // a pass without violating edges proves T to be a dfs forest of the graph
+        // Every restructuring increases the preorder sequence of parent positions, so the passes end,
+        // but their number depends on the graph and the buffer: tens for a directed power-law graph
+        // with a buffer of a few |V| edges, hundreds for an undirected one (deep dfs trees)
+        struct _external_frame_s {
+            int vertex;
+            int child; // the next child of `vertex` in T
+            std::size_t edge; // the next buffered edge of `vertex`
+            int tail; // the last child of `vertex` in the new forest
+        };
+
+        struct _external_dfs_s {
+            // the forest: the children of a vertex as a linked list, the roots are the children of the virtual vertex n
+            int n;
+            std::vector <int> first_child, next_sibling;
+            std::vector <int> new_first_child, new_next_sibling;
+            std::vector <int> pre, last; // preorder number and the last preorder number in the subtree
+            // the streamed edges, grouped by their source when the forest is restructured
+            std::vector <std::pair <int, int>> buffer;
+            std::vector <std::size_t> buffer_offsets;
+            std::vector <int> buffer_targets;
+            std::vector <_external_frame_s> stack;
+
+            std::size_t resident_bytes() const;
+        };
+
+        void _external_restructure (_external_dfs_s &fs);
+        // the dfs forest of the streamed graph for the outer loop visiting the vertices in the `roots` order
+        _external_dfs_s _external_dfs (EdgeStream &edges, const std::vector <int> &roots, bool reverse, std::size_t memory_edges);
+        template <typename Discover, typename Finish>
+        void _external_walk (const _external_dfs_s &fs, Discover on_discover, Finish on_finish);
+
+        SearchResult external_dfs (EdgeStream &edges, bool with_times = false, std::size_t memory_edges = 0);
+        // Kosaraju on semi-external dfs: a dfs of the graph, then of its reverse in the decreasing finish order
+        // The same componnents as `scc`, also numbered in a reverse topological order
+        // (the order of componnents which do not reach each other may differ)
+        Components external_scc (EdgeStream &edges, std::size_t memory_edges = 0);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// EdgeStream
+EdgeStream::EdgeStream (std::string file_name) {
+    this->file_name = file_name;
+    this->snapshot = GraphSnapshot::is_snapshot(file_name);
+
+    std::ifstream infile(file_name, std::ios::binary);
+    if (!infile.is_open())
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    if (!this->snapshot) {
+        int n_vertices, n_edges;
+        graph::read_header(infile, this->directed, n_vertices, n_edges);
+        if (!infile)
+            throw std::invalid_argument("Error: Invalid number of vertices or edges");
+
+        this->n_vertices = n_vertices;
+        this->n_edges = n_edges;
+        this->edges_offset = infile.tellg();
+        return;
+    }
+
+    _snapshot_header header;
+    if (!infile.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::invalid_argument("Error: Not a graph snapshot");
+    if (header.byte_order != _snapshot_byte_order)
+        throw std::invalid_argument("Error: Snapshot saved with a different byte order");
+    if (header.version != GraphSnapshot::version)
+        throw std::invalid_argument("Error: Unsupported snapshot version (" + std::to_string(header.version) + ")");
+
+    std::span <const char> header_fields(reinterpret_cast<const char*>(&header), offsetof(_snapshot_header, header_checksum));
+    if (graph::_checksum(0xcbf29ce484222325, header_fields) != header.header_checksum)
+        throw std::invalid_argument("Error: Corrupted snapshot header");
+
+    if (header.num_vertices > std::uint64_t(std::numeric_limits<int>::max()))
+        throw std::invalid_argument("Error: Corrupted snapshot header");
+
+    this->directed = header.flags & _snapshot_directed;
+    this->n_vertices = header.num_vertices;
+    this->n_edges = header.num_entries;
+    this->offsets.resize(this->n_vertices + 1);
+    if (!infile.read(reinterpret_cast<char*>(this->offsets.data()), this->offsets.size() * sizeof(std::uint64_t)))
+        throw std::invalid_argument("Error: Snapshot is truncated");
+    if (this->offsets[0] != 0 || this->offsets[this->n_vertices] != this->n_edges)
+        throw std::invalid_argument("Error: Corrupted snapshot offsets");
+    // the offsets are resident anyway - monotone offsets keep the sources of a pass below n
+    for (int v = 0; v < this->n_vertices; v++)
+        if (this->offsets[v] > this->offsets[v + 1])
+            throw std::invalid_argument("Error: Corrupted snapshot offsets");
+
+    this->edges_offset = sizeof(header) + this->offsets.size() * sizeof(std::uint64_t);
+    this->counters.bytes_read += this->edges_offset;
+}
+
+bool EdgeStream::is_directed () const {
+    return this->directed;
+}
+
+int EdgeStream::num_vertices () const {
+    return this->n_vertices;
+}
+
+const ExternalStats& EdgeStream::stats () const {
+    return this->counters;
+}
+
+void EdgeStream::_account (std::uint64_t batches, std::size_t resident_bytes) {
+    this->counters.batches += batches;
+    this->counters.resident_bytes = std::max(this->counters.resident_bytes, resident_bytes);
+}
+
+template <typename Consumer>
+void EdgeStream::pass (bool reverse, Consumer consume) {
+    GRAPH_PHASE("pass");
+    std::ifstream infile(this->file_name, std::ios::binary);
+    if (!infile.is_open())
+        throw std::invalid_argument("Could not open: " + this->file_name + "!");
+
+    infile.seekg(this->edges_offset);
+    this->counters.passes++;
+    auto emit = [&](int u, int v) {
+        if (reverse)
+            consume(v, u);
+        else
+            consume(u, v);
+    };
+
+    if (this->snapshot)
+        this->_pass_snapshot(infile, emit);
+    else
+        this->_pass_text(infile, emit);
+}
+
+template <typename Consumer>
+void EdgeStream::_pass_text (std::ifstream &infile, Consumer &emit) {
+    // a block is parsed up to its last whitespace - the cut token is moved to the next block
+    std::vector <char> buffer(2 * EdgeStream::block_size);
+    std::size_t kept = 0;
+    std::uint64_t read = 0;
+    bool has_source = false;
+    int u = 0, value;
+    auto expected = [&]() {
+        return std::invalid_argument("Error: Expected " + std::to_string(this->n_edges) + " edges");
+    };
+
+    while (read < this->n_edges) {
+        infile.read(buffer.data() + kept, EdgeStream::block_size);
+        std::size_t size = kept + infile.gcount();
+        bool at_end = std::size_t(infile.gcount()) < EdgeStream::block_size;
+        this->counters.bytes_read += infile.gcount();
+
+        std::size_t cut = size;
+        if (!at_end)
+            while (cut > 0 && !graph::_is_space(buffer[cut - 1]))
+                cut--;
+        if (cut == 0 && !at_end)
+            throw expected();
+
+        const char *it = buffer.data();
+        const char *end = buffer.data() + cut;
+        while (read < this->n_edges) {
+            while (it < end && graph::_is_space(*it))
+                it++;
+            if (it == end)
+                break;
+            if (!graph::_scan_int(it, end, value))
+                throw expected();
+
+            if (!has_source) {
+                u = value;
+                has_source = true;
+                continue;
+            }
+
+            if (u < 1 || u > this->n_vertices || value < 1 || value > this->n_vertices) {
+                std::string message = "Error: Could not add edge (" + std::to_string(u) + "," + std::to_string(value) + ")";
+                throw std::invalid_argument(message);
+            }
+            emit(u - 1, value - 1);
+            if (!this->directed)
+                emit(value - 1, u - 1);
+            has_source = false;
+            read++;
+        }
+
+        kept = size - cut;
+        std::memmove(buffer.data(), buffer.data() + cut, kept);
+        if (at_end)
+            break;
+    }
+
+    if (read < this->n_edges)
+        throw expected();
+    this->counters.edges_read += this->directed ? read : 2 * read;
+    GRAPH_COUNT(edges_scanned, this->directed ? read : 2 * read);
+}
+
+template <typename Consumer>
+void EdgeStream::_pass_snapshot (std::ifstream &infile, Consumer &emit) {
+    // the sources follow from the offsets kept in memory
+    std::vector <int> block(EdgeStream::block_size / sizeof(int));
+    int u = 0;
+    for (std::uint64_t position = 0; position < this->n_edges; ) {
+        std::size_t count = std::min<std::uint64_t>(block.size(), this->n_edges - position);
+        if (!infile.read(reinterpret_cast<char*>(block.data()), count * sizeof(int)))
+            throw std::invalid_argument("Error: Snapshot is truncated");
+        this->counters.bytes_read += count * sizeof(int);
+
+        for (std::size_t i = 0; i < count; i++, position++) {
+            while (this->offsets[u + 1] <= position)
+                u++;
+            if (block[i] < 0 || block[i] >= this->n_vertices)
+                throw std::invalid_argument("Error: Corrupted snapshot edges");
+            emit(u, block[i]);
+        }
+    }
+
+    this->counters.edges_read += this->n_edges;
+    GRAPH_COUNT(edges_scanned, this->n_edges);
+}
+
+
+// semi-external dfs
+std::size_t algorithm::_external_dfs_s::resident_bytes () const {
+    return (this->first_child.capacity() + this->next_sibling.capacity() + this->new_first_child.capacity()
+            + this->new_next_sibling.capacity() + this->pre.capacity() + this->last.capacity()
+            + this->buffer_targets.capacity()) * sizeof(int)
+         + this->buffer.capacity() * sizeof(std::pair <int, int>)
+         + this->buffer_offsets.capacity() * sizeof(std::size_t)
+         + this->stack.capacity() * sizeof(_external_frame_s);
+}
+
+void algorithm::_external_restructure (algorithm::_external_dfs_s &fs) {
+    GRAPH_PHASE("restructure");
+    int n = fs.n;
+
+    // the buffer grouped by the source (counting sort), the virtual vertex has no edges
+    fs.buffer_offsets.assign(n + 2, 0);
+    for (auto [u, v] : fs.buffer)
+        fs.buffer_offsets[u + 1]++;
+    std::partial_sum(fs.buffer_offsets.begin(), fs.buffer_offsets.end(), fs.buffer_offsets.begin());
+    fs.buffer_targets.resize(fs.buffer.size());
+    for (auto [u, v] : fs.buffer)
+        fs.buffer_targets[fs.buffer_offsets[u]++] = v;
+    for (int u = n + 1; u > 0; u--)
+        fs.buffer_offsets[u] = fs.buffer_offsets[u - 1];
+    fs.buffer_offsets[0] = 0;
+
+    // dfs of T + B from the virtual vertex - the children in T first, then the buffered edges
+    fs.new_first_child.assign(n + 1, -1);
+    fs.pre.assign(n + 1, -1);
+    int clock = 0;
+    fs.stack.push_back(_external_frame_s{.vertex = n, .child = fs.first_child[n], .edge = fs.buffer_offsets[n], .tail = -1});
+    while (!fs.stack.empty()) {
+        _external_frame_s &frame = fs.stack.back();
+        int next = -1;
+        while (next == -1 && frame.child != -1) {
+            int child = frame.child;
+            frame.child = fs.next_sibling[child];
+            if (fs.pre[child] == -1)
+                next = child;
+        }
+        while (next == -1 && frame.edge < fs.buffer_offsets[frame.vertex + 1]) {
+            int adj = fs.buffer_targets[frame.edge++];
+            if (fs.pre[adj] == -1)
+                next = adj;
+        }
+
+        if (next == -1) {
+            fs.last[frame.vertex] = clock - 1;
+            fs.stack.pop_back();
+            continue;
+        }
+
+        fs.new_next_sibling[next] = -1;
+        if (frame.tail == -1)
+            fs.new_first_child[frame.vertex] = next;
+        else
+            fs.new_next_sibling[frame.tail] = next;
+        frame.tail = next;
+        fs.pre[next] = clock++;
+        fs.stack.push_back(_external_frame_s{.vertex = next, .child = fs.first_child[next], .edge = fs.buffer_offsets[next], .tail = -1});
+        GRAPH_HIGH_WATER(max_depth, fs.stack.size());
+    }
+
+    std::swap(fs.first_child, fs.new_first_child);
+    std::swap(fs.next_sibling, fs.new_next_sibling);
+}
+
+algorithm::_external_dfs_s algorithm::_external_dfs (EdgeStream &edges, const std::vector <int> &roots, bool reverse, std::size_t memory_edges) {
+    int n = edges.num_vertices();
+    if (memory_edges == 0)
+        memory_edges = std::max<std::size_t>(4 * std::size_t(n), 1);
+
+    // the initial forest: every vertex is a root
+    algorithm::_external_dfs_s fs;
+    fs.n = n;
+    fs.first_child.assign(n + 1, -1);
+    fs.next_sibling.assign(n + 1, -1);
+    fs.new_next_sibling.assign(n + 1, -1);
+    fs.pre.assign(n + 1, -1);
+    fs.last.assign(n + 1, n - 1);
+    for (int i = n - 1; i >= 0; i--) {
+        fs.next_sibling[roots[i]] = fs.first_child[n];
+        fs.first_child[n] = roots[i];
+        fs.pre[roots[i]] = fs.last[roots[i]] = i;
+    }
+    fs.buffer.reserve(memory_edges);
+
+    // a buffer without violating edges would not change the forest - it is dropped
+    std::uint64_t batches = 0;
+    bool dirty = false;
+    auto restructure = [&]() {
+        if (dirty) {
+            algorithm::_external_restructure(fs);
+            batches++;
+        }
+        fs.buffer.clear();
+        dirty = false;
+    };
+
+    for (bool violated = true; violated; ) {
+        violated = false;
+        edges.pass(reverse, [&](int u, int v) {
+            // v is neither a descendant of u nor before it
+            if (fs.pre[v] > fs.last[u])
+                violated = dirty = true;
+            // forward edges (and loops) are skipped - they rarely become tree edges,
+            // and the buffer holds more of the edges which restructure the forest
+            else if (fs.pre[v] >= fs.pre[u])
+                return;
+
+            fs.buffer.push_back(std::make_pair(u, v));
+            if (fs.buffer.size() == memory_edges)
+                restructure();
+        });
+        restructure();
+    }
+
+    edges._account(batches, fs.resident_bytes());
+    return fs;
+}
+
+template <typename Discover, typename Finish>
+void algorithm::_external_walk (const algorithm::_external_dfs_s &fs, Discover on_discover, Finish on_finish) {
+    // the forest in preorder - on_discover(v, parent) with -1 for the roots
+    std::vector <std::pair <int, int>> stack; // (vertex, next child)
+    for (int root = fs.first_child[fs.n]; root != -1; root = fs.next_sibling[root]) {
+        on_discover(root, -1);
+        stack.push_back(std::make_pair(root, fs.first_child[root]));
+        while (!stack.empty()) {
+            auto &[v, child] = stack.back();
+            if (child == -1) {
+                on_finish(v);
+                stack.pop_back();
+                continue;
+            }
+
+            int next = child;
+            child = fs.next_sibling[next];
+            on_discover(next, v);
+            stack.push_back(std::make_pair(next, fs.first_child[next]));
+        }
+    }
+}
+
+SearchResult algorithm::external_dfs (EdgeStream &edges, bool with_times, std::size_t memory_edges) {
+    int num_vertices = edges.num_vertices();
+    std::vector <int> roots(num_vertices);
+    std::iota(roots.begin(), roots.end(), 0);
+    algorithm::_external_dfs_s fs = algorithm::_external_dfs(edges, roots, false, memory_edges);
+
+    SearchResult search;
+    search.order.reserve(num_vertices);
+    search.parent_idx.assign(num_vertices, -1);
+    if (with_times) {
+        search.discovery.assign(num_vertices, 0);
+        search.finish.assign(num_vertices, 0);
+    }
+
+    int clock = 0;
+    algorithm::_external_walk(fs,
+        [&](int v, int parent) {
+            search.order.push_back(v);
+            search.parent_idx[v] = parent;
+            if (with_times)
+                search.discovery[v] = clock++;
+        },
+        [&](int v) {
+            if (with_times)
+                search.finish[v] = clock++;
+        });
+
+    return search;
+}
+
+Components algorithm::external_scc (EdgeStream &edges, std::size_t memory_edges) {
+    int num_vertices = edges.num_vertices();
+    std::vector <int> order(num_vertices);
+    std::iota(order.begin(), order.end(), 0);
+    algorithm::_external_dfs_s fs = algorithm::_external_dfs(edges, order, false, memory_edges);
+
+    // the decreasing finish order
+    order.clear();
+    algorithm::_external_walk(fs, [](int, int) {}, [&](int v) { order.push_back(v); });
+    std::reverse(order.begin(), order.end());
+
+    // the trees of the reverse dfs are the componnents in a topological order
+    fs = algorithm::_external_dfs(edges, order, true, memory_edges);
+    Components components;
+    for (int root = fs.first_child[fs.n]; root != -1; root = fs.next_sibling[root])
+        components.num_components++;
+
+    components.component_idx.assign(num_vertices, 0);
+    int componnent = components.num_components;
+    algorithm::_external_walk(fs,
+        [&](int v, int parent) {
+            if (parent == -1)
+                componnent--;
+            components.component_idx[v] = componnent;
+        },
+        [](int) {});
+
+    return components;
+}
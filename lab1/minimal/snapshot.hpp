@@ -0,0 +1,287 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <numeric>
+#include <span>
+#include <bit>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "graph.hpp"
+#include "mapped_file.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    /*
+    Binary snapshot of a frozen IntGraph (native byte order, every section 8-byte aligned)
+    header (_snapshot_header)
+    out_offsets - (n + 1) x uint64
+    out_targets - m x int32
+    in_offsets - (n + 1) x uint64, graphs saved with in-degrees only
+    in_sources, in_positions - m x int32 each, graphs saved with the reverse CSR only
+    */
+    struct _snapshot_header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order; // `_snapshot_byte_order` written in the native byte order
+        std::uint64_t flags;
+        std::uint64_t num_vertices;
+        std::uint64_t num_entries; // size of out_targets
+        std::uint64_t payload_checksum; // of all the sections
+        std::uint64_t header_checksum; // of the fields above
+    };
+
+    constexpr char _snapshot_magic[8] = {'A', 'O', 'D', 'G', 'R', 'A', 'P', 'H'};
+    constexpr std::uint32_t _snapshot_byte_order = 0x01020304;
+    constexpr std::uint64_t _snapshot_directed = 1;
+    constexpr std::uint64_t _snapshot_in_degrees = 2;
+    constexpr std::uint64_t _snapshot_reverse_csr = 4;
+
+    std::size_t _snapshot_padded (std::size_t size); // rounded up to a multiple of 8
+    std::uint64_t _checksum (std::uint64_t hash, std::span <const char> bytes); // word-wise FNV-1a
+
+
+
+    class GraphSnapshot {
+        // Read-only graph opened from a snapshot file without copying or parsing:
+        // the view points directly into the memory mapping, so opening takes
+        // constant time and the pages are loaded only when an algorithm touches them
+        // Only the header, the sizes and the ends of the offsets are checked on opening - `verify` also checks
+        // the payload checksum and the structure (monotone offsets, vertices in range) in O(n + m)
+        private:
+            MappedFile file;
+            IntGraphView graph;
+            std::vector <std::size_t> in_offsets; // computed for directed graphs saved without in-degrees
+
+        public:
+            static constexpr std::uint32_t version = 1;
+
+            GraphSnapshot() = default;
+            GraphSnapshot (std::string file_name, bool verify = false);
+            // moving keeps the mapping and the vector buffers in place, so the view stays valid
+            GraphSnapshot (GraphSnapshot &&other) = default;
+            GraphSnapshot& operator = (GraphSnapshot &&other) = default;
+            ~GraphSnapshot() = default;
+
+            IntGraphView view() const;
+
+            // checks only the magic bytes
+            static bool is_snapshot (std::string file_name);
+            // the reverse CSR (and so the in-degrees) is saved if the graph has it
+            static void save (IntGraphView graph, std::string file_name, bool with_in_degrees = true);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+std::size_t graph::_snapshot_padded (std::size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+std::uint64_t graph::_checksum (std::uint64_t hash, std::span <const char> bytes) {
+    constexpr std::uint64_t prime = 0x100000001b3;
+    std::size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes.data() + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < bytes.size(); i++)
+        hash = (hash ^ (unsigned char)bytes[i]) * prime;
+    return hash;
+}
+
+
+// GraphSnapshot
+GraphSnapshot::GraphSnapshot (std::string file_name, bool verify) {
+    static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "snapshot offsets are stored as uint64");
+
+    std::cout << "Mapping snapshot...\n";
+    this->file = MappedFile(file_name);
+    std::span <const char> bytes = this->file.data();
+
+    _snapshot_header header;
+    if (bytes.size() < sizeof(header))
+        throw std::invalid_argument("Error: Not a graph snapshot");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, _snapshot_magic, sizeof(header.magic)) != 0)
+        throw std::invalid_argument("Error: Not a graph snapshot");
+    if (header.byte_order != _snapshot_byte_order)
+        throw std::invalid_argument("Error: Snapshot saved with a different byte order");
+    if (header.version != GraphSnapshot::version)
+        throw std::invalid_argument("Error: Unsupported snapshot version (" + std::to_string(header.version) + ")");
+
+    std::span <const char> header_fields = bytes.subspan(0, offsetof(_snapshot_header, header_checksum));
+    if (graph::_checksum(0xcbf29ce484222325, header_fields) != header.header_checksum)
+        throw std::invalid_argument("Error: Corrupted snapshot header");
+
+    bool directed = header.flags & _snapshot_directed;
+    bool with_in_degrees = header.flags & _snapshot_in_degrees;
+    bool with_reverse_csr = header.flags & _snapshot_reverse_csr;
+    std::size_t n = header.num_vertices;
+    std::size_t m = header.num_entries;
+    if (n > std::size_t(std::numeric_limits<int>::max()) || m > bytes.size())
+        throw std::invalid_argument("Error: Corrupted snapshot header");
+
+    std::size_t offsets_size = (n + 1) * sizeof(std::size_t);
+    std::size_t targets_size = _snapshot_padded(m * sizeof(int));
+    std::size_t expected_size = sizeof(header) + offsets_size + targets_size;
+    if (with_in_degrees)
+        expected_size += offsets_size;
+    if (with_reverse_csr)
+        expected_size += 2 * targets_size;
+    if (bytes.size() != expected_size)
+        throw std::invalid_argument("Error: Snapshot is truncated");
+
+    std::span <const char> payload = bytes.subspan(sizeof(header));
+    if (verify && graph::_checksum(0xcbf29ce484222325, payload) != header.payload_checksum)
+        throw std::invalid_argument("Error: Snapshot checksum mismatch");
+
+    // the sections - the mapping is page aligned and every section is 8-byte aligned
+    const char *section = payload.data();
+    auto next_offsets = [&]() {
+        std::span <const std::size_t> offsets(reinterpret_cast<const std::size_t*>(section), n + 1);
+        section += offsets_size;
+        return offsets;
+    };
+    auto next_targets = [&]() {
+        std::span <const int> targets(reinterpret_cast<const int*>(section), m);
+        section += targets_size;
+        return targets;
+    };
+
+    // only the ends of the offsets by default - `verify` checks every index the view hands out
+    auto check_offsets = [&](std::span <const std::size_t> offsets) {
+        if (offsets[0] != 0 || offsets[n] != m)
+            throw std::invalid_argument("Error: Corrupted snapshot offsets");
+        if (!verify)
+            return;
+        for (std::size_t v = 0; v < n; v++)
+            if (offsets[v] > offsets[v + 1])
+                throw std::invalid_argument("Error: Corrupted snapshot offsets");
+    };
+    auto check_vertices = [&](std::span <const int> vertices) {
+        if (!verify)
+            return;
+        for (int v : vertices)
+            if (v < 0 || std::size_t(v) >= n)
+                throw std::invalid_argument("Error: Corrupted snapshot edges");
+    };
+
+    std::span <const std::size_t> out_offsets = next_offsets();
+    std::span <const int> out_targets = next_targets();
+    check_offsets(out_offsets);
+    check_vertices(out_targets);
+
+    std::span <const std::size_t> in_offsets = out_offsets; // undirected graphs
+    if (with_in_degrees) {
+        in_offsets = next_offsets();
+        check_offsets(in_offsets);
+    }
+    else if (directed) {
+        this->in_offsets.assign(n + 1, 0);
+        for (int adj : out_targets) {
+            if (adj < 0 || std::size_t(adj) >= n) // the pass is O(m) anyway
+                throw std::invalid_argument("Error: Corrupted snapshot edges");
+            this->in_offsets[adj + 1]++;
+        }
+        std::partial_sum(this->in_offsets.begin(), this->in_offsets.end(), this->in_offsets.begin());
+        in_offsets = this->in_offsets;
+    }
+
+    std::span <const int> in_sources, in_positions;
+    if (with_reverse_csr) {
+        in_sources = next_targets();
+        in_positions = next_targets();
+        check_vertices(in_sources);
+        for (std::size_t i = 0; verify && i < m; i++) {
+            int source = in_sources[i];
+            if (in_positions[i] < 0 || std::size_t(in_positions[i]) >= out_offsets[source + 1] - out_offsets[source])
+                throw std::invalid_argument("Error: Corrupted snapshot edges");
+        }
+    }
+
+    this->graph = IntGraphView(directed, n, out_offsets, out_targets, in_offsets, in_sources, in_positions);
+    std::cout << "Success!\n";
+}
+
+IntGraphView GraphSnapshot::view () const {
+    return this->graph;
+}
+
+bool GraphSnapshot::is_snapshot (std::string file_name) {
+    std::ifstream infile(file_name, std::ios::binary);
+    char magic[sizeof(_snapshot_magic)];
+    if (!infile.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, _snapshot_magic, sizeof(magic)) == 0;
+}
+
+void GraphSnapshot::save (IntGraphView graph, std::string file_name, bool with_in_degrees) {
+    std::ofstream outfile(file_name, std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open())
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    _snapshot_header header{};
+    std::memcpy(header.magic, _snapshot_magic, sizeof(header.magic));
+    header.version = GraphSnapshot::version;
+    header.byte_order = _snapshot_byte_order;
+    header.num_vertices = graph.num_vertices();
+    header.num_entries = graph.num_edges();
+
+    bool with_reverse_csr = graph.has_reverse_csr();
+    if (graph.is_directed())
+        header.flags |= _snapshot_directed;
+    if ((graph.is_directed() && with_in_degrees) || with_reverse_csr)
+        header.flags |= _snapshot_in_degrees;
+    if (with_reverse_csr)
+        header.flags |= _snapshot_reverse_csr;
+
+    // the header is written last - after the payload checksum is known
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::uint64_t checksum = 0xcbf29ce484222325;
+    auto write_section = [&](auto array) {
+        // the padded section is hashed word by word - as it is read back by `verify`
+        std::span <const char> bytes(reinterpret_cast<const char*>(array.data()), array.size_bytes());
+        std::size_t full_words = bytes.size() / 8 * 8;
+        char last_word[8] = {};
+        std::memcpy(last_word, bytes.data() + full_words, bytes.size() - full_words);
+
+        outfile.write(bytes.data(), full_words);
+        checksum = graph::_checksum(checksum, bytes.first(full_words));
+        if (full_words < bytes.size()) {
+            outfile.write(last_word, sizeof(last_word));
+            checksum = graph::_checksum(checksum, last_word);
+        }
+    };
+
+    write_section(graph.out_offsets);
+    write_section(graph.out_targets);
+    if (header.flags & _snapshot_in_degrees)
+        write_section(graph.in_offsets);
+    if (header.flags & _snapshot_reverse_csr) {
+        write_section(graph.in_sources);
+        write_section(graph.in_positions);
+    }
+
+    header.payload_checksum = checksum;
+    header.header_checksum = graph::_checksum(
+        0xcbf29ce484222325,
+        std::span<const char>(reinterpret_cast<const char*>(&header), offsetof(_snapshot_header, header_checksum))
+    );
+    outfile.seekp(0);
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!outfile)
+        throw std::runtime_error("Could not write: " + file_name + "!");
+}
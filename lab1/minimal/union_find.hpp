@@ -0,0 +1,193 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "graph.hpp"
+#include "parallel.hpp"
+
+
+
+
+
+// Declarations
+namespace graph {
+    class ParityUnionFind {
+        // Lock-free union-find with parity bits (Anderson-Woll style linking)
+        // Every vertex stores its parent and the parity of the edge to it in one word,
+        // so the parity of a path is kept consistent by the same CAS which compresses it
+        // An edge (u, v) means that u and v lie on different sides of a bipartition
+        // Roots are linked only under larger vertices, so concurrent links cannot form cycles
+        private:
+            std::vector <std::uint64_t> words; // parent << 1 | parity
+            int num_sets;
+            bool odd_cycle = false;
+
+        public:
+            ParityUnionFind() = default;
+            ParityUnionFind (int num_vertices);
+            ~ParityUnionFind() = default;
+
+            int num_vertices() const;
+            int num_components() const;
+            bool is_bipartite() const;
+            std::pair <int, int> find (int vertex); // (root, parity of the path to the root)
+            void unite (int u, int v); // safe to call concurrently with other `unite` / `find` calls
+
+            // the same partition as `algorithm::bipartite_partition` for undirected graphs:
+            // the smallest vertex of every componnent is red
+            std::pair <std::vector <int>, std::vector <int>> bipartite_partition();
+    };
+
+
+
+    namespace algorithm {
+        // connectivity and bipartiteness of a graph file without storing the graph - O(|V|) memory
+        // The edges are read in batches and united by all the threads of the team
+        // Only undirected graphs - the components and the bipartiteness of `bi` are not defined for directed ones
+        ParityUnionFind stream_components (std::string file_name, int num_threads = 0, std::size_t batch_size = 1 << 20);
+    };
+}
+
+// Definitions
+using namespace graph;
+
+// ParityUnionFind
+ParityUnionFind::ParityUnionFind (int num_vertices) {
+    this->words.resize(num_vertices);
+    for (int v = 0; v < num_vertices; v++)
+        this->words[v] = std::uint64_t(v) << 1;
+    this->num_sets = num_vertices;
+}
+
+int ParityUnionFind::num_vertices () const {
+    return this->words.size();
+}
+
+int ParityUnionFind::num_components () const {
+    return std::atomic_ref<const int>(this->num_sets).load();
+}
+
+bool ParityUnionFind::is_bipartite () const {
+    return !std::atomic_ref<const bool>(this->odd_cycle).load();
+}
+
+std::pair <int, int> ParityUnionFind::find (int vertex) {
+    // path splitting: every visited vertex is moved to its grandparent
+    int parity = 0;
+    while (true) {
+        std::atomic_ref <std::uint64_t> word(this->words[vertex]);
+        std::uint64_t current = word.load(std::memory_order_acquire);
+        int parent = current >> 1;
+        if (parent == vertex)
+            return std::make_pair(vertex, parity);
+
+        std::uint64_t parent_word = std::atomic_ref<std::uint64_t>(this->words[parent]).load(std::memory_order_acquire);
+        int grandparent = parent_word >> 1;
+        if (grandparent != parent) {
+            // on a failure the CAS overwrites its expected value - `current` must stay the word the walk follows
+            std::uint64_t expected = current;
+            std::uint64_t compressed = (std::uint64_t(grandparent) << 1) | ((current ^ parent_word) & 1);
+            word.compare_exchange_weak(expected, compressed, std::memory_order_release, std::memory_order_relaxed);
+        }
+
+        parity ^= current & 1;
+        vertex = parent;
+    }
+}
+
+void ParityUnionFind::unite (int u, int v) {
+    while (true) {
+        auto [u_root, u_parity] = this->find(u);
+        auto [v_root, v_parity] = this->find(v);
+        if (u_root == v_root) {
+            // the relative parity of u and v does not change once they are in one set
+            if (u_parity == v_parity)
+                std::atomic_ref<bool>(this->odd_cycle).store(true);
+            return;
+        }
+
+        if (u_root > v_root) {
+            std::swap(u_root, v_root);
+            std::swap(u_parity, v_parity);
+        }
+
+        // u_parity ^ link ^ v_parity must be odd
+        std::uint64_t root_word = std::uint64_t(u_root) << 1;
+        std::uint64_t link = (std::uint64_t(v_root) << 1) | (1 ^ u_parity ^ v_parity);
+        if (std::atomic_ref<std::uint64_t>(this->words[u_root]).compare_exchange_strong(root_word, link, std::memory_order_acq_rel)) {
+            std::atomic_ref<int>(this->num_sets).fetch_sub(1);
+            return;
+        }
+    }
+}
+
+std::pair <std::vector <int>, std::vector <int>> ParityUnionFind::bipartite_partition () {
+    if (!this->is_bipartite())
+        throw std::invalid_argument("Graph is NOT bipartite!");
+
+    // parity of the smallest vertex of every componnent, stored at its root
+    int num_vertices = this->num_vertices();
+    std::vector <std::int8_t> root_parity(num_vertices, -1);
+    std::vector <int> red_vertices, blue_vertices;
+    for (int v = 0; v < num_vertices; v++) {
+        auto [root, parity] = this->find(v);
+        if (root_parity[root] == -1)
+            root_parity[root] = parity;
+
+        if (parity == root_parity[root])
+            red_vertices.push_back(v);
+        else
+            blue_vertices.push_back(v);
+    }
+
+    return std::make_pair(red_vertices, blue_vertices);
+}
+
+
+// streaming
+ParityUnionFind algorithm::stream_components (std::string file_name, int num_threads, std::size_t batch_size) {
+    std::ifstream infile;
+    infile.open(file_name);
+
+    if (!infile.is_open())
+        throw std::invalid_argument("Could not open: " + file_name + "!");
+
+    bool directed;
+    int n_vertices, n_edges;
+    graph::read_header(infile, directed, n_vertices, n_edges);
+    if (directed)
+        throw std::invalid_argument("Graph is directed - the streamed components need an undirected graph!");
+
+    ParityUnionFind uf(n_vertices);
+    parallel::Team team(num_threads);
+    std::vector <std::pair <int, int>> batch;
+    batch.reserve(std::min<std::size_t>(batch_size, n_edges));
+
+    int u, v;
+    for (int read = 0; read < n_edges; ) {
+        batch.clear();
+        for (; read < n_edges && batch.size() < batch_size; read++) {
+            if (!(infile >> u >> v))
+                throw std::invalid_argument("Error: Expected " + std::to_string(n_edges) + " edges");
+
+            if (u < 1 || u > n_vertices || v < 1 || v > n_vertices) {
+                std::string message = "Error: Could not add edge (" + std::to_string(u) + "," + std::to_string(v) + ")";
+                throw std::invalid_argument(message);
+            }
+            batch.push_back(std::make_pair(u - 1, v - 1));
+        }
+
+        team.run([&](int thread_id) {
+            auto [first, last] = parallel::chunk(batch.size(), thread_id, team.size());
+            for (std::size_t i = first; i < last; i++)
+                uf.unite(batch[i].first, batch[i].second);
+        });
+    }
+
+    return uf;
+}